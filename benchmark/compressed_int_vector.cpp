@@ -0,0 +1,61 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#include <CompressedIntVector.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+template<typename T>
+void run(const std::string &name, const Vector<T> &values) {
+    const CompressedIntVector<T> compressed(values);
+    const size_t rounds = 20;
+    T checksum = 0;
+    T buffer[CompressedIntVector<T>::block_size];
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t block = 0; block < compressed.block_count(); ++block) {
+            const size_t count = compressed.decode_block(block, buffer);
+            for (size_t i = 0; i < count; ++i) {
+                checksum += buffer[i];
+            }
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    const double decoded_bytes = static_cast<double>(rounds * values.size() * sizeof(T));
+    std::cout << name
+              << ": bytes/element " << static_cast<double>(compressed.memory_bytes()) / values.size()
+              << " (raw " << sizeof(T) << ")"
+              << ", decode " << decoded_bytes / elapsed.count() / 1e9 << " GB/s"
+              << ", checksum " << checksum << std::endl;
+}
+
+int main() {
+    const size_t count = 1 << 24;
+    uint64_t state = 88172645463325252ull;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    Vector<uint32_t> sorted_ids;
+    Vector<uint32_t> counters;
+    Vector<uint64_t> sorted_ids64;
+    sorted_ids.reserve(count);
+    counters.reserve(count);
+    sorted_ids64.reserve(count);
+    uint64_t id = 0;
+    for (size_t i = 0; i < count; ++i) {
+        id += 1 + next() % 64;
+        sorted_ids.push_back(static_cast<uint32_t>(id));
+        counters.push_back(static_cast<uint32_t>(next() % 4096));
+        sorted_ids64.push_back((uint64_t(1) << 40) + id);
+    }
+
+    run("sorted uint32 ids", sorted_ids);
+    run("uint32 counters", counters);
+    run("sorted uint64 ids", sorted_ids64);
+    return 0;
+}
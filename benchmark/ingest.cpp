@@ -0,0 +1,78 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#include <Ingest.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+template<typename Function>
+void measure(const std::string &name, size_t bytes, Function function) {
+    const auto start = Clock::now();
+    const size_t count = function();
+    const std::chrono::duration<double> elapsed = Clock::now() - start;
+    std::cout << "    " << name << ": " << static_cast<double>(bytes) / elapsed.count() / 1e6 << " MB/s ("
+              << count << " values)" << std::endl;
+}
+
+size_t naive_loop(const std::string &path) {
+    std::ifstream input(path);
+    Vector<double> values;
+    std::string line;
+    while (std::getline(input, line)) {
+        values.push_back(std::stod(line));
+    }
+    return values.size();
+}
+
+int main() {
+    const size_t count = 10000000;
+    const std::string text_path = "ingest_benchmark.txt";
+    const std::string binary_path = "ingest_benchmark.bin";
+    uint64_t state = 88172645463325252ull;
+    {
+        std::FILE *text = std::fopen(text_path.c_str(), "wb");
+        std::FILE *binary = std::fopen(binary_path.c_str(), "wb");
+        for (size_t i = 0; i < count; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            const double value = static_cast<double>(state % 100000000) / 1000.0;
+            std::fprintf(text, "%.3f\n", value);
+            std::fwrite(&value, sizeof(value), 1, binary);
+        }
+        std::fclose(text);
+        std::fclose(binary);
+    }
+    const size_t text_bytes = ingest_detail::file_size(text_path);
+    const size_t binary_bytes = ingest_detail::file_size(binary_path);
+
+    std::cout << "text, " << text_bytes << " bytes" << std::endl;
+    measure("getline + stod + push_back", text_bytes, [&text_path]() { return naive_loop(text_path); });
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t used = 1; used <= threads; used *= 2) {
+        measure("ingest_text on " + std::to_string(used) + " threads", text_bytes, [&text_path, used]() {
+            IngestOptions options;
+            options.threads = used;
+            Vector<double> values;
+            ingest_text(text_path, values, options);
+            return values.size();
+        });
+    }
+
+    std::cout << "binary, " << binary_bytes << " bytes" << std::endl;
+    measure("ingest_binary", binary_bytes, [&binary_path]() {
+        Vector<double> values;
+        ingest_binary(binary_path, values);
+        return values.size();
+    });
+
+    std::remove(text_path.c_str());
+    std::remove(binary_path.c_str());
+    return 0;
+}
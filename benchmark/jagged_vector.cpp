@@ -0,0 +1,87 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#include <JaggedVector.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+double milliseconds_since(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+uint32_t neighbour(size_t row, size_t i) {
+    return static_cast<uint32_t>((row * 2654435761u + i * 40503u) & 0xFFFFF);
+}
+
+size_t degree(size_t row) {
+    return (row * 7919) % 32;
+}
+
+template<typename Rows>
+void traverse(const std::string &name, const Rows &rows, size_t count) {
+    const auto start = Clock::now();
+    uint64_t checksum = 0;
+    for (size_t round = 0; round < 10; ++round) {
+        for (size_t row = 0; row < count; ++row) {
+            const auto &values = rows[row];
+            for (size_t i = 0; i < values.size(); ++i) {
+                checksum += values[i];
+            }
+        }
+    }
+    std::cout << "    traverse " << name << ": " << milliseconds_since(start) / 10 << " ms (checksum " << checksum
+              << ")" << std::endl;
+}
+
+int main() {
+    const size_t rows = 1 << 20;
+    std::cout << rows << " rows" << std::endl;
+
+    auto start = Clock::now();
+    Vector<Vector<uint32_t>> nested;
+    nested.reserve(rows);
+    for (size_t row = 0; row < rows; ++row) {
+        Vector<uint32_t> values;
+        for (size_t i = 0; i < degree(row); ++i) {
+            values.push_back(neighbour(row, i));
+        }
+        nested.push_back(std::move(values));
+    }
+    std::cout << "    build Vector<Vector<uint32_t>>: " << milliseconds_since(start) << " ms" << std::endl;
+
+    start = Clock::now();
+    JaggedVector<uint32_t> pushed;
+    for (size_t row = 0; row < rows; ++row) {
+        pushed.push_row();
+        for (size_t i = 0; i < degree(row); ++i) {
+            pushed.push_back(neighbour(row, i));
+        }
+    }
+    std::cout << "    build JaggedVector with push_row/push_back: " << milliseconds_since(start) << " ms" << std::endl;
+
+    start = Clock::now();
+    const JaggedVector<uint32_t> converted(nested);
+    std::cout << "    convert from Vector<Vector<uint32_t>>: " << milliseconds_since(start) << " ms" << std::endl;
+
+    const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t used = 1; used <= threads; used *= 2) {
+        start = Clock::now();
+        const auto built = JaggedVector<uint32_t>::build(
+                rows, degree,
+                [](size_t row, uint32_t *out) {
+                    for (size_t i = 0; i < degree(row); ++i) {
+                        out[i] = neighbour(row, i);
+                    }
+                }, used);
+        std::cout << "    two-pass build on " << used << " threads: " << milliseconds_since(start) << " ms ("
+                  << built.size() << " values)" << std::endl;
+    }
+
+    traverse("Vector<Vector<uint32_t>>", nested, rows);
+    traverse("JaggedVector", converted, rows);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#include <NumaAllocator.h>
+#include <Vector.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using NumaVector = Vector<uint64_t, NumaAllocator<uint64_t>>;
+
+void report(const std::string &name, const NumaVector &vec) {
+    const size_t nodes = numa_node_count();
+    const size_t page_elements = 4096 / sizeof(uint64_t);
+    Vector<size_t> pages(nodes + 1, size_t(0));
+    for (size_t i = 0; i < vec.size(); i += page_elements * 64) {
+        const int node = numa_node_of(vec.data() + i);
+        ++pages[node < 0 || static_cast<size_t>(node) >= nodes ? nodes : static_cast<size_t>(node)];
+    }
+    std::cout << name << ": sampled pages per node";
+    for (size_t node = 0; node < nodes; ++node) {
+        std::cout << " [" << node << "] " << pages[node];
+    }
+    std::cout << " [unknown] " << pages[nodes] << std::endl;
+
+    for (size_t node = 0; node < nodes; ++node) {
+        double bandwidth = 0;
+        uint64_t checksum = 0;
+        std::thread reader([&vec, &bandwidth, &checksum, node]() {
+            numa_bind_current_thread(node);
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t round = 0; round < 4; ++round) {
+                for (size_t i = 0; i < vec.size(); ++i) {
+                    checksum += vec[i];
+                }
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            bandwidth = 4.0 * static_cast<double>(vec.size() * sizeof(uint64_t)) / elapsed.count() / 1e9;
+        });
+        reader.join();
+        std::cout << "    reader on node " << node << ": " << bandwidth << " GB/s (checksum " << checksum << ")"
+                  << std::endl;
+    }
+}
+
+int main() {
+    const size_t count = size_t(1) << 26;
+    std::cout << "nodes: " << numa_node_count() << ", elements: " << count << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    const NumaVector serial(count, 1, NumaAllocator<uint64_t>(NumaPolicy::Default));
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "serial fill " << elapsed.count() << " s" << std::endl;
+    report("serial fill", serial);
+
+    ParallelConstruct parallel;
+    parallel.on_start = numa_spread_workers;
+    start = std::chrono::steady_clock::now();
+    const NumaVector first_touch(count, 1, parallel, NumaAllocator<uint64_t>(NumaPolicy::Local));
+    elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "parallel first touch " << elapsed.count() << " s" << std::endl;
+    report("parallel first touch", first_touch);
+
+    const NumaVector interleaved(count, 1, parallel, NumaAllocator<uint64_t>(NumaPolicy::Interleave));
+    report("interleave", interleaved);
+
+    const NumaVector bound(count, 1, parallel, NumaAllocator<uint64_t>(NumaPolicy::Bind, 0));
+    report("bind to node 0", bound);
+    return 0;
+}
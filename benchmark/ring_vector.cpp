@@ -0,0 +1,212 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#include <ConcurrentQueue.h>
+#include <RingVector.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void fifo_single_thread() {
+    const size_t depth = 1024;
+    const size_t operations = 200000;
+    uint64_t checksum = 0;
+
+    Vector<uint64_t> vector_fifo;
+    for (size_t i = 0; i < depth; ++i) {
+        vector_fifo.push_back(i);
+    }
+    auto start = Clock::now();
+    for (size_t i = 0; i < operations / 100; ++i) {
+        checksum += vector_fifo.back();
+        vector_fifo.pop_back();
+        auto position = vector_fifo.begin();
+        vector_fifo.insert(position, i);
+    }
+    const double vector_rate = static_cast<double>(operations / 100) / seconds_since(start);
+
+    RingVector<uint64_t> ring(depth);
+    for (size_t i = 0; i < depth; ++i) {
+        ring.push_back(i);
+    }
+    start = Clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        checksum += ring.front();
+        ring.pop_front();
+        ring.push_back(i);
+    }
+    const double ring_rate = static_cast<double>(operations) / seconds_since(start);
+
+    std::cout << "FIFO depth " << depth << ": Vector insert/pop_back " << vector_rate / 1e6
+              << " Mops/s, RingVector " << ring_rate / 1e6 << " Mops/s (checksum " << checksum << ")" << std::endl;
+}
+
+void spsc(size_t batch) {
+    const size_t count = 1 << 22;
+    SPSCQueue<uint64_t> queue(4096);
+    uint64_t buffer[256] = {};
+    const auto start = Clock::now();
+    std::thread producer([&queue, batch]() {
+        uint64_t data[256];
+        for (size_t i = 0; i < count;) {
+            const size_t n = std::min(batch, count - i);
+            for (size_t j = 0; j < n; ++j) {
+                data[j] = i + j;
+            }
+            const size_t pushed = queue.push_batch(data, n);
+            if (pushed == 0) {
+                std::this_thread::yield();
+            }
+            i += pushed;
+        }
+    });
+    uint64_t checksum = 0;
+    for (size_t received = 0; received < count;) {
+        const size_t popped = queue.pop_batch(buffer, batch);
+        if (popped == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t j = 0; j < popped; ++j) {
+            checksum += buffer[j];
+        }
+        received += popped;
+    }
+    producer.join();
+    std::cout << "SPSC batch " << batch << ": " << static_cast<double>(count) / seconds_since(start) / 1e6
+              << " Mitems/s (checksum " << checksum << ")" << std::endl;
+}
+
+void spsc_latency() {
+    const size_t round_trips = 100000;
+    SPSCQueue<uint64_t> ping(16);
+    SPSCQueue<uint64_t> pong(16);
+    std::thread echo([&ping, &pong]() {
+        uint64_t value = 0;
+        for (size_t i = 0; i < round_trips; ++i) {
+            while (!ping.try_pop(value)) {
+                std::this_thread::yield();
+            }
+            while (!pong.try_push(value)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    const auto start = Clock::now();
+    uint64_t value = 0;
+    for (size_t i = 0; i < round_trips; ++i) {
+        while (!ping.try_push(i)) {
+            std::this_thread::yield();
+        }
+        while (!pong.try_pop(value)) {
+            std::this_thread::yield();
+        }
+    }
+    echo.join();
+    std::cout << "SPSC round trip latency: " << seconds_since(start) / round_trips * 1e9 << " ns" << std::endl;
+}
+
+uint64_t nanoseconds_since(Clock::time_point start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+}
+
+// Producers enqueue the time at which each item was written, so consumers
+// measure per-item enqueue-to-dequeue latency alongside throughput.
+void mpmc(size_t threads, size_t batch) {
+    const size_t per_thread = (1 << 21) / threads;
+    const size_t total = per_thread * threads;
+    const size_t sample_every = 16;
+    MPMCQueue<uint64_t> queue(4096);
+    std::atomic<size_t> received(0);
+    std::atomic<uint64_t> latency_sum(0);
+    std::atomic<uint64_t> latency_max(0);
+    Vector<uint64_t> *samples = new Vector<uint64_t>[threads];
+    std::thread *workers = new std::thread[2 * threads];
+    const auto start = Clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers[2 * t] = std::thread([&queue, start, per_thread, batch]() {
+            uint64_t data[256];
+            for (size_t i = 0; i < per_thread;) {
+                const size_t n = std::min(batch, per_thread - i);
+                const uint64_t now = nanoseconds_since(start);
+                for (size_t j = 0; j < n; ++j) {
+                    data[j] = now;
+                }
+                const size_t pushed = batch == 1 ? (queue.try_push(data[0]) ? 1 : 0) : queue.push_batch(data, n);
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                i += pushed;
+            }
+        });
+        workers[2 * t + 1] = std::thread([&queue, &received, &latency_sum, &latency_max, samples, t, start, total,
+                                          batch, sample_every]() {
+            uint64_t data[256];
+            uint64_t sum = 0;
+            uint64_t max = 0;
+            size_t seen = 0;
+            while (received.load(std::memory_order_relaxed) < total) {
+                const size_t popped = batch == 1 ? (queue.try_pop(data[0]) ? 1 : 0) : queue.pop_batch(data, batch);
+                if (popped == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                const uint64_t now = nanoseconds_since(start);
+                for (size_t j = 0; j < popped; ++j) {
+                    const uint64_t latency = now - data[j];
+                    sum += latency;
+                    max = std::max(max, latency);
+                    if (seen++ % sample_every == 0) {
+                        samples[t].push_back(latency);
+                    }
+                }
+                received.fetch_add(popped, std::memory_order_relaxed);
+            }
+            latency_sum += sum;
+            uint64_t current = latency_max.load();
+            while (max > current && !latency_max.compare_exchange_weak(current, max)) {}
+        });
+    }
+    for (size_t i = 0; i < 2 * threads; ++i) {
+        workers[i].join();
+    }
+    const double elapsed = seconds_since(start);
+    delete[] workers;
+
+    Vector<uint64_t> all;
+    for (size_t t = 0; t < threads; ++t) {
+        for (size_t i = 0; i < samples[t].size(); ++i) {
+            all.push_back(samples[t][i]);
+        }
+    }
+    delete[] samples;
+    std::sort(all.data(), all.data() + all.size());
+    auto percentile = [&all](double fraction) {
+        return all.empty() ? 0 : all[static_cast<size_t>(fraction * static_cast<double>(all.size() - 1))];
+    };
+    std::cout << "MPMC " << threads << "P/" << threads << "C batch " << batch << ": "
+              << static_cast<double>(total) / elapsed / 1e6 << " Mitems/s, latency mean "
+              << latency_sum.load() / total << " ns, p50 " << percentile(0.5) << " ns, p99 " << percentile(0.99)
+              << " ns, max " << latency_max.load() << " ns" << std::endl;
+}
+
+int main() {
+    fifo_single_thread();
+    spsc(1);
+    spsc(64);
+    spsc_latency();
+    const size_t max_threads = std::max(2u, std::thread::hardware_concurrency()) / 2;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        mpmc(threads, 1);
+        mpmc(threads, 64);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#include <Sort.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <utility>
+
+struct Payload {
+    uint64_t a;
+    uint64_t b;
+};
+
+using Record = std::pair<uint32_t, Payload>;
+
+template<typename T, typename Function>
+void measure(const std::string &name, const Vector<T> &input, Function function) {
+    Vector<T> values(input);
+    const auto start = std::chrono::steady_clock::now();
+    function(values);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "    " << name << ": " << elapsed.count() * 1e3 << " ms, "
+              << static_cast<double>(values.size()) / elapsed.count() / 1e6 << " Melements/s" << std::endl;
+}
+
+int main() {
+    const size_t count = size_t(1) << 23;
+    uint64_t state = 88172645463325252ull;
+    auto next = [&state]() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    Vector<uint64_t> keys;
+    Vector<double> doubles;
+    Vector<Record> records;
+    keys.reserve(count);
+    doubles.reserve(count);
+    records.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t value = next();
+        keys.push_back(value);
+        doubles.push_back(static_cast<double>(static_cast<int64_t>(value)) * 1e-9);
+        records.push_back(Record(static_cast<uint32_t>(value), Payload{value, i}));
+    }
+
+    std::cout << "Vector<uint64_t>, " << count << " elements" << std::endl;
+    measure("std::sort", keys, [](Vector<uint64_t> &v) { std::sort(v.data(), v.data() + v.size()); });
+    measure("pdq_sort", keys, [](Vector<uint64_t> &v) { pdq_sort(v); });
+    measure("radix_sort", keys, [](Vector<uint64_t> &v) { radix_sort(v); });
+    measure("msd_radix_sort", keys, [](Vector<uint64_t> &v) { msd_radix_sort(v); });
+    measure("parallel_radix_sort", keys, [](Vector<uint64_t> &v) { parallel_radix_sort(v); });
+
+    std::cout << "Vector<double>" << std::endl;
+    measure("std::sort", doubles, [](Vector<double> &v) { std::sort(v.data(), v.data() + v.size()); });
+    measure("radix_sort", doubles, [](Vector<double> &v) { radix_sort(v); });
+
+    auto key = [](const Record &record) { return record.first; };
+    auto less = [](const Record &lhs, const Record &rhs) { return lhs.first < rhs.first; };
+    std::cout << "Vector<std::pair<uint32_t, Payload>>" << std::endl;
+    measure("std::sort", records, [&less](Vector<Record> &v) { std::sort(v.data(), v.data() + v.size(), less); });
+    measure("pdq_sort", records, [&less](Vector<Record> &v) { pdq_sort(v, less); });
+    measure("radix_sort", records, [&key](Vector<Record> &v) { radix_sort(v, key); });
+    measure("msd_radix_sort", records, [&key](Vector<Record> &v) { msd_radix_sort(v, key); });
+    measure("parallel_radix_sort", records, [&key](Vector<Record> &v) { parallel_radix_sort(v, key); });
+    return 0;
+}
@@ -0,0 +1,384 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_COMPRESSEDINTVECTOR_H
+#define VECTOR_COMPRESSEDINTVECTOR_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <Vector.h>
+
+// Values are grouped in blocks of block_size. A full block stores either the
+// offset of every value from the block minimum (frame of reference) or, for
+// non-decreasing blocks, the difference to the previous value (delta). The
+// residuals are bit-packed in four interleaved 32-bit lanes: value i goes to
+// lane i % 4, so one 128-bit load yields the next word of every lane and a
+// whole block is unpacked with vector shifts. The last, incomplete block is
+// kept uncompressed until it fills up.
+//
+// Random access reads one block header. Frame-of-reference blocks then
+// extract the value directly; delta blocks start from the nearest checkpoint
+// kept in the header every checkpoint_interval_ values and add at most
+// checkpoint_interval_ - 1 deltas.
+template<typename T>
+class CompressedIntVector {
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                  "CompressedIntVector requires an unsigned integral type");
+    static_assert(sizeof(T) <= sizeof(uint64_t), "CompressedIntVector supports at most 64-bit values");
+
+public:
+    static constexpr size_t block_size = 128;
+
+private:
+    static constexpr size_t lanes_ = 4;
+    static constexpr size_t lane_values_ = block_size / lanes_;
+    static constexpr size_t checkpoint_interval_ = 32;
+    static constexpr size_t checkpoints_ = block_size / checkpoint_interval_ - 1;
+
+    enum class Encoding : uint8_t {
+        FrameOfReference,
+        Delta,
+        Raw
+    };
+
+    struct BlockHeader {
+        T base;
+        T checkpoints[checkpoints_];
+        size_t offset;
+        uint8_t bits;
+        Encoding encoding;
+    };
+
+    Vector<uint32_t> words_;
+    Vector<BlockHeader> headers_;
+    Vector<T> tail_;
+    size_t size_;
+
+    static uint8_t bit_width(uint64_t value) noexcept {
+        uint8_t bits = 0;
+        while (value != 0) {
+            ++bits;
+            value >>= 1;
+        }
+        return bits;
+    }
+
+    static uint32_t lane_mask(uint8_t bits) noexcept {
+        return bits == 32 ? ~uint32_t(0) : (uint32_t(1) << bits) - 1;
+    }
+
+    // 0-bit blocks (all residuals zero) store no words, so words must not be
+    // read for them.
+    static uint32_t extract(const uint32_t *words, uint8_t bits, size_t index) noexcept {
+        if (bits == 0) {
+            return 0;
+        }
+        const size_t lane = index % lanes_;
+        const size_t bit = (index / lanes_) * bits;
+        const size_t word = bit / 32;
+        const size_t shift = bit % 32;
+        uint32_t value = words[word * lanes_ + lane] >> shift;
+        if (shift + bits > 32) {
+            value |= words[(word + 1) * lanes_ + lane] << (32 - shift);
+        }
+        return value & lane_mask(bits);
+    }
+
+    static void unpack(const uint32_t *words, uint8_t bits, uint32_t *out) noexcept {
+        if (bits == 0) {
+            std::fill(out, out + block_size, 0);
+            return;
+        }
+#if defined(__SSE2__)
+        const __m128i mask = _mm_set1_epi32(static_cast<int>(lane_mask(bits)));
+        const __m128i *in = reinterpret_cast<const __m128i *>(words);
+        __m128i current = _mm_loadu_si128(in);
+        uint32_t shift = 0;
+        for (size_t k = 0; k < lane_values_; ++k) {
+            __m128i value = _mm_srl_epi32(current, _mm_cvtsi32_si128(static_cast<int>(shift)));
+            shift += bits;
+            if (shift >= 32) {
+                shift -= 32;
+                ++in;
+                if (shift > 0) {
+                    current = _mm_loadu_si128(in);
+                    value = _mm_or_si128(value,
+                                         _mm_sll_epi32(current, _mm_cvtsi32_si128(static_cast<int>(bits - shift))));
+                } else if (k + 1 < lane_values_) {
+                    current = _mm_loadu_si128(in);
+                }
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + k * lanes_), _mm_and_si128(value, mask));
+        }
+#else
+        for (size_t i = 0; i < block_size; ++i) {
+            out[i] = extract(words, bits, i);
+        }
+#endif
+    }
+
+    void pack(const uint32_t *residuals, uint8_t bits) {
+        uint32_t packed[block_size] = {};
+        for (size_t i = 0; i < block_size; ++i) {
+            const size_t lane = i % lanes_;
+            const size_t bit = (i / lanes_) * bits;
+            const size_t word = bit / 32;
+            const size_t shift = bit % 32;
+            packed[word * lanes_ + lane] |= residuals[i] << shift;
+            if (shift + bits > 32) {
+                packed[(word + 1) * lanes_ + lane] |= residuals[i] >> (32 - shift);
+            }
+        }
+        for (size_t i = 0; i < lanes_ * bits; ++i) {
+            words_.push_back(packed[i]);
+        }
+    }
+
+    void flush() {
+        const T *values = tail_.data();
+        T min = values[0];
+        T max = values[0];
+        T max_delta = 0;
+        bool sorted = true;
+        for (size_t i = 1; i < block_size; ++i) {
+            min = std::min(min, values[i]);
+            max = std::max(max, values[i]);
+            if (values[i] < values[i - 1]) {
+                sorted = false;
+            } else {
+                max_delta = std::max(max_delta, static_cast<T>(values[i] - values[i - 1]));
+            }
+        }
+
+        BlockHeader header{};
+        header.offset = words_.size();
+        const uint8_t for_bits = bit_width(max - min);
+        const uint8_t delta_bits = sorted ? bit_width(max_delta) : 64;
+        uint32_t residuals[block_size];
+        if (delta_bits < for_bits && delta_bits <= 32) {
+            header.encoding = Encoding::Delta;
+            header.base = values[0];
+            header.bits = delta_bits;
+            residuals[0] = 0;
+            for (size_t i = 1; i < block_size; ++i) {
+                residuals[i] = static_cast<uint32_t>(values[i] - values[i - 1]);
+            }
+            for (size_t i = 0; i < checkpoints_; ++i) {
+                header.checkpoints[i] = values[(i + 1) * checkpoint_interval_];
+            }
+            pack(residuals, header.bits);
+        } else if (for_bits <= 32) {
+            header.encoding = Encoding::FrameOfReference;
+            header.base = min;
+            header.bits = for_bits;
+            for (size_t i = 0; i < block_size; ++i) {
+                residuals[i] = static_cast<uint32_t>(values[i] - min);
+            }
+            pack(residuals, header.bits);
+        } else {
+            header.encoding = Encoding::Raw;
+            header.base = 0;
+            header.bits = 64;
+            for (size_t i = 0; i < block_size; ++i) {
+                const uint64_t value = values[i];
+                words_.push_back(static_cast<uint32_t>(value));
+                words_.push_back(static_cast<uint32_t>(value >> 32));
+            }
+        }
+        headers_.push_back(header);
+        tail_.clear();
+    }
+
+    T get_compressed(size_t block, size_t index) const noexcept {
+        const BlockHeader &header = headers_[block];
+        const uint32_t *words = words_.data() + header.offset;
+        switch (header.encoding) {
+            case Encoding::FrameOfReference:
+                return header.base + extract(words, header.bits, index);
+            case Encoding::Delta: {
+                const size_t checkpoint = index / checkpoint_interval_;
+                T value = checkpoint == 0 ? header.base : header.checkpoints[checkpoint - 1];
+                for (size_t i = checkpoint * checkpoint_interval_ + 1; i <= index; ++i) {
+                    value += extract(words, header.bits, i);
+                }
+                return value;
+            }
+            default:
+                return combine(words[2 * index], words[2 * index + 1]);
+        }
+    }
+
+    template<typename U>
+    static void shrink_to_fit(Vector<U> &vec) {
+        if (vec.capacity() != vec.size()) {
+            Vector<U> exact(vec.size(), vec.data());
+            vec.swap(exact);
+        }
+    }
+
+    static T combine(uint32_t low, uint32_t high) noexcept {
+        if constexpr (sizeof(T) > sizeof(uint32_t)) {
+            return static_cast<T>(low) | (static_cast<T>(high) << 32);
+        } else {
+            (void) high;
+            return static_cast<T>(low);
+        }
+    }
+
+public:
+    class const_iterator {
+    private:
+        const CompressedIntVector *owner_;
+        size_t index_;
+        size_t loaded_block_;
+        T buffer_[block_size];
+
+        void load() {
+            const size_t block = index_ / block_size;
+            if (block != loaded_block_ && index_ < owner_->size_) {
+                owner_->decode_block(block, buffer_);
+                loaded_block_ = block;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator(const CompressedIntVector *owner, size_t index)
+                : owner_(owner), index_(index), loaded_block_(static_cast<size_t>(-1)) {
+            load();
+        }
+
+        const_iterator &operator++() {
+            ++index_;
+            if (index_ % block_size == 0) {
+                load();
+            }
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator old(*this);
+            ++*this;
+            return old;
+        }
+
+        const T &operator*() const { return buffer_[index_ % block_size]; }
+
+        bool operator==(const const_iterator &rhs) const noexcept { return index_ == rhs.index_; }
+
+        bool operator!=(const const_iterator &rhs) const noexcept { return index_ != rhs.index_; }
+    };
+
+    CompressedIntVector() : size_(0) {
+        tail_.reserve(block_size);
+    }
+
+    explicit CompressedIntVector(const Vector<T> &values) : CompressedIntVector() {
+        headers_.reserve(values.size() / block_size);
+        for (size_t i = 0; i < values.size(); ++i) {
+            push_back(values[i]);
+        }
+        shrink_to_fit(words_);
+        shrink_to_fit(tail_);
+    }
+
+    void push_back(T value) {
+        tail_.push_back(value);
+        ++size_;
+        if (tail_.size() == block_size) {
+            flush();
+        }
+    }
+
+    T operator[](size_t index) const {
+        const size_t block = index / block_size;
+        if (block < headers_.size()) {
+            return get_compressed(block, index % block_size);
+        }
+        return tail_[index - headers_.size() * block_size];
+    }
+
+    T at(size_t index) const {
+        if (index < size_) {
+            return (*this)[index];
+        }
+        throw std::out_of_range("Index out of range");
+    }
+
+    size_t decode_block(size_t block, T *out) const {
+        if (block >= headers_.size()) {
+            std::copy(tail_.data(), tail_.data() + tail_.size(), out);
+            return tail_.size();
+        }
+        const BlockHeader &header = headers_[block];
+        const uint32_t *words = words_.data() + header.offset;
+        if (header.encoding == Encoding::Raw) {
+            for (size_t i = 0; i < block_size; ++i) {
+                out[i] = combine(words[2 * i], words[2 * i + 1]);
+            }
+            return block_size;
+        }
+        uint32_t residuals[block_size];
+        unpack(words, header.bits, residuals);
+        if (header.encoding == Encoding::Delta) {
+            T value = header.base;
+            for (size_t i = 0; i < block_size; ++i) {
+                value += residuals[i];
+                out[i] = value;
+            }
+        } else {
+            for (size_t i = 0; i < block_size; ++i) {
+                out[i] = header.base + residuals[i];
+            }
+        }
+        return block_size;
+    }
+
+    template<typename Function>
+    void for_each(Function function) const {
+        T buffer[block_size];
+        for (size_t block = 0; block < block_count(); ++block) {
+            const size_t count = decode_block(block, buffer);
+            for (size_t i = 0; i < count; ++i) {
+                function(buffer[i]);
+            }
+        }
+    }
+
+    Vector<T> to_vector() const {
+        Vector<T> result;
+        result.reserve(size_);
+        for_each([&result](T value) { result.push_back(value); });
+        return result;
+    }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, size_); }
+
+    size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    size_t block_count() const noexcept { return headers_.size() + (tail_.empty() ? 0 : 1); }
+
+    // Counts allocated capacity, not just the bytes in use.
+    size_t memory_bytes() const noexcept {
+        return words_.capacity() * sizeof(uint32_t) + headers_.capacity() * sizeof(BlockHeader)
+               + tail_.capacity() * sizeof(T);
+    }
+};
+
+#endif //VECTOR_COMPRESSEDINTVECTOR_H
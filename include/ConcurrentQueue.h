@@ -0,0 +1,258 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_CONCURRENTQUEUE_H
+#define VECTOR_CONCURRENTQUEUE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+#include <Vector.h>
+#include <RingVector.h>
+
+constexpr size_t cache_line_size = 64;
+
+// Single-producer single-consumer queue. Each side owns its index and keeps a
+// cached copy of the other side's index, re-reading the shared atomic only
+// when the cached value says the queue is full (or empty).
+template<typename T>
+class SPSCQueue {
+private:
+    Vector<T> buffer_;
+    size_t mask_;
+    alignas(cache_line_size) std::atomic<size_t> head_;
+    size_t cached_tail_;
+    alignas(cache_line_size) std::atomic<size_t> tail_;
+    size_t cached_head_;
+
+    size_t writable(size_t tail) noexcept {
+        if (tail - cached_head_ == buffer_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        return buffer_.size() - (tail - cached_head_);
+    }
+
+    size_t readable(size_t head) noexcept {
+        if (cached_tail_ == head) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        return cached_tail_ - head;
+    }
+
+public:
+    explicit SPSCQueue(size_t capacity)
+            : buffer_(ring_capacity(capacity)), mask_(buffer_.size() - 1),
+              head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
+    SPSCQueue(const SPSCQueue &) = delete;
+
+    SPSCQueue &operator=(const SPSCQueue &) = delete;
+
+    bool try_push(const T &value) {
+        return try_emplace(value);
+    }
+
+    bool try_push(T &&value) {
+        return try_emplace(std::move(value));
+    }
+
+    template<typename U>
+    bool try_emplace(U &&value) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (writable(tail) == 0) {
+            return false;
+        }
+        buffer_[tail & mask_] = std::forward<U>(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T &value) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (readable(head) == 0) {
+            return false;
+        }
+        value = std::move(buffer_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t push_batch(const T *data, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        const size_t pushed = std::min(count, writable(tail));
+        for (size_t i = 0; i < pushed; ++i) {
+            buffer_[(tail + i) & mask_] = data[i];
+        }
+        tail_.store(tail + pushed, std::memory_order_release);
+        return pushed;
+    }
+
+    size_t pop_batch(T *out, size_t count) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t popped = std::min(count, readable(head));
+        for (size_t i = 0; i < popped; ++i) {
+            out[i] = std::move(buffer_[(head + i) & mask_]);
+        }
+        head_.store(head + popped, std::memory_order_release);
+        return popped;
+    }
+
+    size_t size_approx() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept { return buffer_.size(); }
+};
+
+// Multi-producer multi-consumer queue after Dmitry Vyukov's bounded queue:
+// every cell carries a sequence number telling whether it is ready to be
+// written (sequence == position) or read (sequence == position + 1), and
+// producers and consumers claim positions with a CAS on tail_ and head_.
+// Batch operations claim a whole range at once and may briefly wait for
+// threads that claimed the same cells one lap earlier to finish with them.
+template<typename T>
+class MPMCQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+
+        Cell() : sequence(0), value() {}
+
+        Cell(const Cell &rhs) : sequence(rhs.sequence.load(std::memory_order_relaxed)), value(rhs.value) {}
+    };
+
+    Vector<Cell> cells_;
+    size_t mask_;
+    alignas(cache_line_size) std::atomic<size_t> head_;
+    alignas(cache_line_size) std::atomic<size_t> tail_;
+
+    static void wait_for(const Cell &cell, size_t sequence) noexcept {
+        while (cell.sequence.load(std::memory_order_acquire) != sequence) {
+            std::this_thread::yield();
+        }
+    }
+
+public:
+    explicit MPMCQueue(size_t capacity)
+            : cells_(ring_capacity(capacity)), mask_(cells_.size() - 1), head_(0), tail_(0) {
+        for (size_t i = 0; i < cells_.size(); ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MPMCQueue(const MPMCQueue &) = delete;
+
+    MPMCQueue &operator=(const MPMCQueue &) = delete;
+
+    bool try_push(const T &value) {
+        return try_emplace(value);
+    }
+
+    bool try_push(T &&value) {
+        return try_emplace(std::move(value));
+    }
+
+    template<typename U>
+    bool try_emplace(U &&value) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[position & mask_];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::forward<U>(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T &value) {
+        size_t position = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells_[position & mask_];
+            const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            const auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+            if (difference == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(position + cells_.size(), std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    size_t push_batch(const T *data, size_t count) {
+        size_t position = tail_.load(std::memory_order_relaxed);
+        size_t claimed = 0;
+        for (;;) {
+            const size_t used = position - head_.load(std::memory_order_acquire);
+            if (used > cells_.size()) {
+                position = tail_.load(std::memory_order_relaxed);
+                continue;
+            }
+            claimed = std::min(count, cells_.size() - used);
+            if (claimed == 0) {
+                return 0;
+            }
+            if (tail_.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (size_t i = 0; i < claimed; ++i) {
+            Cell &cell = cells_[(position + i) & mask_];
+            wait_for(cell, position + i);
+            cell.value = data[i];
+            cell.sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    size_t pop_batch(T *out, size_t count) {
+        size_t position = head_.load(std::memory_order_relaxed);
+        size_t claimed = 0;
+        for (;;) {
+            const size_t available = tail_.load(std::memory_order_acquire) - position;
+            if (available > cells_.size()) {
+                position = head_.load(std::memory_order_relaxed);
+                continue;
+            }
+            claimed = std::min(count, available);
+            if (claimed == 0) {
+                return 0;
+            }
+            if (head_.compare_exchange_weak(position, position + claimed, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+        for (size_t i = 0; i < claimed; ++i) {
+            Cell &cell = cells_[(position + i) & mask_];
+            wait_for(cell, position + i + 1);
+            out[i] = std::move(cell.value);
+            cell.sequence.store(position + i + cells_.size(), std::memory_order_release);
+        }
+        return claimed;
+    }
+
+    size_t size_approx() const noexcept {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const noexcept { return cells_.size(); }
+};
+
+#endif //VECTOR_CONCURRENTQUEUE_H
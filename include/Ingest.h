@@ -0,0 +1,397 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_INGEST_H
+#define VECTOR_INGEST_H
+
+#include <algorithm>
+#include <charconv>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+#if defined(__SSE2__) && (defined(__GNUC__) || defined(__clang__))
+#define VECTOR_INGEST_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <Vector.h>
+
+struct IngestOptions {
+    size_t chunk_size = size_t(1) << 20;
+    // Number of threads the file is split across; 0 means one per hardware
+    // thread. Only text ingest is split.
+    size_t threads = 1;
+};
+
+namespace ingest_detail {
+    inline bool is_delimiter(char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == ',' || c == ';';
+    }
+
+#if defined(VECTOR_INGEST_SSE2)
+    inline unsigned delimiter_mask(const char *p) noexcept {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i match = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\t')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8('\r')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(',')));
+        match = _mm_or_si128(match, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(';')));
+        return static_cast<unsigned>(_mm_movemask_epi8(match));
+    }
+#endif
+
+    // Scans 16 bytes at a time with SSE2 where available.
+    inline const char *skip_delimiters(const char *p, const char *end) noexcept {
+#if defined(VECTOR_INGEST_SSE2)
+        while (end - p >= 16) {
+            const unsigned mask = delimiter_mask(p);
+            if (mask != 0xFFFF) {
+                return p + __builtin_ctz(~mask);
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && is_delimiter(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    inline const char *find_delimiter(const char *p, const char *end) noexcept {
+#if defined(VECTOR_INGEST_SSE2)
+        while (end - p >= 16) {
+            const unsigned mask = delimiter_mask(p);
+            if (mask != 0) {
+                return p + __builtin_ctz(mask);
+            }
+            p += 16;
+        }
+#endif
+        while (p < end && !is_delimiter(*p)) {
+            ++p;
+        }
+        return p;
+    }
+
+    inline std::FILE *open(const std::string &path) {
+        std::FILE *file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            throw std::runtime_error("Cannot open file: " + path);
+        }
+        return file;
+    }
+
+    inline size_t file_size(const std::string &path) {
+        std::FILE *file = open(path);
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fclose(file);
+        if (size < 0) {
+            throw std::runtime_error("Cannot determine size of file: " + path);
+        }
+        return static_cast<size_t>(size);
+    }
+
+    // Returns the first position at or after position that starts a token,
+    // i.e. that follows a delimiter.
+    inline size_t align_to_token(const std::string &path, size_t position, size_t size) {
+        if (position == 0 || position >= size) {
+            return std::min(position, size);
+        }
+        std::FILE *file = open(path);
+        std::fseek(file, static_cast<long>(position - 1), SEEK_SET);
+        char window[4096];
+        size_t offset = position - 1;
+        size_t read = 0;
+        while ((read = std::fread(window, 1, sizeof(window), file)) > 0) {
+            const char *delimiter = find_delimiter(window, window + read);
+            if (delimiter != window + read) {
+                std::fclose(file);
+                return offset + static_cast<size_t>(delimiter - window) + 1;
+            }
+            offset += read;
+        }
+        std::fclose(file);
+        return size;
+    }
+}
+
+// Reads [offset, offset + length) of a file in chunks on a background
+// thread. While the caller works on one buffer the thread fills the other.
+class ChunkReader {
+private:
+    std::FILE *file_;
+    size_t chunk_size_;
+    size_t remaining_;
+    Vector<char> storage_;
+    size_t sizes_[2];
+    bool filled_[2];
+    size_t current_;
+    bool finished_;
+    bool stop_;
+    std::exception_ptr error_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+
+    static constexpr size_t none_ = static_cast<size_t>(-1);
+
+    void read_loop() {
+        try {
+            for (size_t index = 0;; index ^= 1) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    condition_.wait(lock, [this, index]() { return !filled_[index] || stop_; });
+                    if (stop_) {
+                        return;
+                    }
+                }
+                const size_t wanted = std::min(chunk_size_, remaining_);
+                const size_t read = std::fread(storage_.data() + index * chunk_size_, 1, wanted, file_);
+                if (read < wanted && std::ferror(file_) != 0) {
+                    throw std::runtime_error("Error while reading file");
+                }
+                remaining_ -= read;
+                const bool done = read < wanted || remaining_ == 0;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    sizes_[index] = read;
+                    filled_[index] = true;
+                    finished_ = done;
+                }
+                condition_.notify_all();
+                if (done) {
+                    return;
+                }
+            }
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                error_ = std::current_exception();
+                finished_ = true;
+            }
+            condition_.notify_all();
+        }
+    }
+
+public:
+    ChunkReader(const std::string &path, size_t chunk_size, size_t offset = 0, size_t length = none_)
+            : file_(ingest_detail::open(path)), chunk_size_(std::max<size_t>(1, chunk_size)), remaining_(length),
+              storage_(2 * chunk_size_), sizes_(), filled_(), current_(none_), finished_(false), stop_(false) {
+        if (std::fseek(file_, static_cast<long>(offset), SEEK_SET) != 0) {
+            std::fclose(file_);
+            throw std::runtime_error("Cannot seek in file: " + path);
+        }
+        thread_ = std::thread(&ChunkReader::read_loop, this);
+    }
+
+    ChunkReader(const ChunkReader &) = delete;
+
+    ChunkReader &operator=(const ChunkReader &) = delete;
+
+    ~ChunkReader() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        condition_.notify_all();
+        thread_.join();
+        std::fclose(file_);
+    }
+
+    // Hands out the next chunk; the previous one is given back to the reader.
+    bool next(const char *&data, size_t &size) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        size_t index = 0;
+        if (current_ != none_) {
+            filled_[current_] = false;
+            index = current_ ^ 1;
+            condition_.notify_all();
+        }
+        condition_.wait(lock, [this, index]() { return filled_[index] || finished_; });
+        if (error_ != nullptr) {
+            std::rethrow_exception(error_);
+        }
+        if (!filled_[index] || sizes_[index] == 0) {
+            current_ = none_;
+            return false;
+        }
+        current_ = index;
+        data = storage_.data() + index * chunk_size_;
+        size = sizes_[index];
+        return true;
+    }
+};
+
+// Parses delimited numbers from consecutive chunks straight into a Vector.
+// A number split across two chunks is the only thing that is copied.
+template<typename T>
+class TextParser {
+    static_assert(std::is_arithmetic<T>::value, "TextParser requires an arithmetic type");
+
+private:
+    Vector<T> &out_;
+    Vector<char> carry_;
+    size_t parsed_;
+
+    void parse(const char *p, const char *end) {
+        for (;;) {
+            p = ingest_detail::skip_delimiters(p, end);
+            if (p == end) {
+                return;
+            }
+            T value;
+            const auto result = std::from_chars(p, end, value);
+            if (result.ec != std::errc() || (result.ptr != end && !ingest_detail::is_delimiter(*result.ptr))) {
+                const char *token_end = ingest_detail::find_delimiter(p, end);
+                throw std::runtime_error("Invalid number: " + std::string(p, token_end));
+            }
+            out_.push_back(value);
+            ++parsed_;
+            p = result.ptr;
+        }
+    }
+
+    void append_carry(const char *p, const char *end) {
+        for (; p < end; ++p) {
+            carry_.push_back(*p);
+        }
+    }
+
+public:
+    explicit TextParser(Vector<T> &out) : out_(out), parsed_(0) {}
+
+    void feed(const char *data, size_t size) {
+        const char *p = data;
+        const char *end = data + size;
+        if (!carry_.empty()) {
+            const char *token_end = ingest_detail::find_delimiter(p, end);
+            append_carry(p, token_end);
+            if (token_end == end) {
+                return;
+            }
+            parse(carry_.data(), carry_.data() + carry_.size());
+            carry_.clear();
+            p = token_end;
+        }
+        const char *parse_end = end;
+        while (parse_end > p && !ingest_detail::is_delimiter(*(parse_end - 1))) {
+            --parse_end;
+        }
+        parse(p, parse_end);
+        append_carry(parse_end, end);
+    }
+
+    void finish() {
+        parse(carry_.data(), carry_.data() + carry_.size());
+        carry_.clear();
+    }
+
+    size_t parsed() const noexcept { return parsed_; }
+};
+
+namespace ingest_detail {
+    // After the first chunk the number of values in the whole range is
+    // estimated from that chunk's density and reserved once.
+    template<typename T>
+    void ingest_text_range(const std::string &path, size_t offset, size_t length, Vector<T> &out, size_t chunk_size) {
+        ChunkReader reader(path, chunk_size, offset, length);
+        TextParser<T> parser(out);
+        const char *data = nullptr;
+        size_t size = 0;
+        bool first = true;
+        while (reader.next(data, size)) {
+            parser.feed(data, size);
+            if (first && size < length) {
+                const size_t estimate = parser.parsed() * (length / size + 1);
+                out.reserve(out.size() + estimate + estimate / 16);
+            }
+            first = false;
+        }
+        parser.finish();
+    }
+}
+
+// Appends every number in a text file to out. Numbers may be separated by
+// any run of spaces, tabs, newlines, commas and semicolons.
+template<typename T>
+void ingest_text(const std::string &path, Vector<T> &out, const IngestOptions &options = IngestOptions()) {
+    const size_t size = ingest_detail::file_size(path);
+    const size_t chunk_size = std::max<size_t>(1, options.chunk_size);
+    size_t threads = options.threads != 0 ? options.threads : std::thread::hardware_concurrency();
+    threads = std::max<size_t>(1, std::min(threads, size / chunk_size + 1));
+    if (threads == 1) {
+        ingest_detail::ingest_text_range(path, 0, size, out, chunk_size);
+        return;
+    }
+
+    std::unique_ptr<size_t[]> bounds(new size_t[threads + 1]);
+    for (size_t worker = 0; worker <= threads; ++worker) {
+        bounds[worker] = ingest_detail::align_to_token(path, size * worker / threads, size);
+    }
+    std::unique_ptr<Vector<T>[]> parts(new Vector<T>[threads]);
+    std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[threads]);
+    std::unique_ptr<std::thread[]> workers(new std::thread[threads]);
+    for (size_t worker = 0; worker < threads; ++worker) {
+        workers[worker] = std::thread([&, worker]() {
+            try {
+                if (bounds[worker + 1] > bounds[worker]) {
+                    ingest_detail::ingest_text_range(path, bounds[worker], bounds[worker + 1] - bounds[worker],
+                                                     parts[worker], chunk_size);
+                }
+            } catch (...) {
+                errors[worker] = std::current_exception();
+            }
+        });
+    }
+    for (size_t worker = 0; worker < threads; ++worker) {
+        workers[worker].join();
+    }
+    size_t total = 0;
+    for (size_t worker = 0; worker < threads; ++worker) {
+        if (errors[worker] != nullptr) {
+            std::rethrow_exception(errors[worker]);
+        }
+        total += parts[worker].size();
+    }
+    out.reserve(out.size() + total);
+    for (size_t worker = 0; worker < threads; ++worker) {
+        const T *values = parts[worker].data();
+        for (size_t i = 0; i < parts[worker].size(); ++i) {
+            out.push_back(values[i]);
+        }
+    }
+}
+
+// Appends the raw values stored in a binary file to out. The element count is
+// known from the file size, so out is reserved once up front.
+template<typename T>
+void ingest_binary(const std::string &path, Vector<T> &out, const IngestOptions &options = IngestOptions()) {
+    static_assert(std::is_trivially_copyable<T>::value, "ingest_binary requires a trivially copyable type");
+    const size_t size = ingest_detail::file_size(path);
+    if (size % sizeof(T) != 0) {
+        throw std::runtime_error("File size is not a multiple of the element size: " + path);
+    }
+    out.reserve(out.size() + size / sizeof(T));
+    const size_t chunk_size = std::max<size_t>(1, options.chunk_size / sizeof(T)) * sizeof(T);
+    ChunkReader reader(path, chunk_size, 0, size);
+    const char *data = nullptr;
+    size_t read = 0;
+    while (reader.next(data, read)) {
+        for (size_t i = 0; i + sizeof(T) <= read; i += sizeof(T)) {
+            T value;
+            std::memcpy(&value, data + i, sizeof(T));
+            out.push_back(value);
+        }
+    }
+}
+
+#endif //VECTOR_INGEST_H
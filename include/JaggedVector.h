@@ -0,0 +1,251 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_JAGGEDVECTOR_H
+#define VECTOR_JAGGEDVECTOR_H
+
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <Vector.h>
+
+// Rows of varying length stored back to back in one Vector (compressed
+// sparse row layout). Row i occupies values_[offsets_[i], offsets_[i + 1]).
+template<typename T>
+class JaggedVector {
+public:
+    template<typename U>
+    class Row {
+    private:
+        U *data_;
+        size_t size_;
+
+    public:
+        Row(U *data, size_t size) : data_(data), size_(size) {}
+
+        U &operator[](size_t index) const { return data_[index]; }
+
+        U *begin() const noexcept { return data_; }
+
+        U *end() const noexcept { return data_ + size_; }
+
+        U *data() const noexcept { return data_; }
+
+        size_t size() const noexcept { return size_; }
+
+        bool empty() const noexcept { return size_ == 0; }
+    };
+
+    using row_type = Row<T>;
+
+    using const_row_type = Row<const T>;
+
+    // Two-pass construction for rows filled in arbitrary order, e.g. from an
+    // edge list: count() every element first, then add() them.
+    class Builder {
+    private:
+        Vector<size_t> offsets_;
+        Vector<size_t> cursors_;
+        Vector<T> values_;
+        bool allocated_;
+
+        void allocate() {
+            for (size_t row = 1; row < offsets_.size(); ++row) {
+                offsets_[row] += offsets_[row - 1];
+            }
+            Vector<size_t> cursors(offsets_);
+            cursors_.swap(cursors);
+            Vector<T> values(offsets_.back());
+            values_.swap(values);
+            allocated_ = true;
+        }
+
+    public:
+        explicit Builder(size_t rows) : offsets_(rows + 1, size_t(0)), allocated_(false) {}
+
+        void count(size_t row, size_t amount = 1) {
+            if (allocated_) {
+                throw std::logic_error("JaggedVector::Builder::count called after add");
+            }
+            if (row >= offsets_.size() - 1) {
+                throw std::out_of_range("Index out of range");
+            }
+            offsets_[row + 1] += amount;
+        }
+
+        void add(size_t row, const T &value) {
+            if (row >= offsets_.size() - 1) {
+                throw std::out_of_range("Index out of range");
+            }
+            if (!allocated_) {
+                allocate();
+            }
+            if (cursors_[row] == offsets_[row + 1]) {
+                throw std::out_of_range("Row is already full");
+            }
+            values_[cursors_[row]++] = value;
+        }
+
+        JaggedVector finish() {
+            if (!allocated_) {
+                allocate();
+            }
+            return JaggedVector(std::move(values_), std::move(offsets_));
+        }
+    };
+
+private:
+    Vector<T> values_;
+    Vector<size_t> offsets_;
+
+    JaggedVector(Vector<T> &&values, Vector<size_t> &&offsets)
+            : values_(std::move(values)), offsets_(std::move(offsets)) {}
+
+    template<typename Function>
+    static void for_each_row_range(size_t rows, size_t threads, const Function &function) {
+        threads = std::max<size_t>(1, std::min(threads, rows));
+        if (threads == 1) {
+            function(0, rows);
+            return;
+        }
+        std::unique_ptr<std::thread[]> workers(new std::thread[threads - 1]);
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers[worker - 1] = std::thread(function, rows * worker / threads, rows * (worker + 1) / threads);
+        }
+        function(0, rows / threads);
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers[worker - 1].join();
+        }
+    }
+
+public:
+    JaggedVector() {
+        offsets_.push_back(0);
+    }
+
+    explicit JaggedVector(const Vector<Vector<T>> &rows) : JaggedVector() {
+        size_t total = 0;
+        for (size_t row = 0; row < rows.size(); ++row) {
+            total += rows[row].size();
+        }
+        reserve(rows.size(), total);
+        for (size_t row = 0; row < rows.size(); ++row) {
+            push_row(rows[row]);
+        }
+    }
+
+    // Counts every row with count(row), allocates once, then lets
+    // fill(row, out) write the row's elements to out. Both passes are split
+    // over threads by row ranges.
+    template<typename CountFunction, typename FillFunction>
+    static JaggedVector build(size_t rows, CountFunction count, FillFunction fill, size_t threads = 1) {
+        Vector<size_t> offsets(rows + 1, size_t(0));
+        for_each_row_range(rows, threads, [&offsets, &count](size_t first, size_t last) {
+            for (size_t row = first; row < last; ++row) {
+                offsets[row + 1] = count(row);
+            }
+        });
+        for (size_t row = 1; row <= rows; ++row) {
+            offsets[row] += offsets[row - 1];
+        }
+        Vector<T> values(offsets[rows]);
+        for_each_row_range(rows, threads, [&offsets, &values, &fill](size_t first, size_t last) {
+            for (size_t row = first; row < last; ++row) {
+                fill(row, values.data() + offsets[row]);
+            }
+        });
+        return JaggedVector(std::move(values), std::move(offsets));
+    }
+
+    const_row_type operator[](size_t row) const {
+        return const_row_type(values_.data() + offsets_[row], offsets_[row + 1] - offsets_[row]);
+    }
+
+    row_type operator[](size_t row) {
+        return row_type(values_.data() + offsets_[row], offsets_[row + 1] - offsets_[row]);
+    }
+
+    const_row_type at(size_t row) const {
+        if (row < rows()) {
+            return (*this)[row];
+        }
+        throw std::out_of_range("Index out of range");
+    }
+
+    row_type at(size_t row) {
+        if (row < rows()) {
+            return (*this)[row];
+        }
+        throw std::out_of_range("Index out of range");
+    }
+
+    const Vector<T> &values() const noexcept { return values_; }
+
+    const Vector<size_t> &offsets() const noexcept { return offsets_; }
+
+    size_t rows() const noexcept { return offsets_.size() - 1; }
+
+    size_t size() const noexcept { return values_.size(); }
+
+    bool empty() const noexcept { return rows() == 0; }
+
+    void reserve(size_t rows, size_t values) {
+        offsets_.reserve(rows + 1);
+        values_.reserve(values);
+    }
+
+    void clear() {
+        values_.clear();
+        offsets_.clear();
+        offsets_.push_back(0);
+    }
+
+    void push_row() {
+        offsets_.push_back(values_.size());
+    }
+
+    // data may point into this JaggedVector (e.g. to duplicate a row); such
+    // a source is copied by offset, since reserve() may reallocate it.
+    void push_row(const T *data, size_t count) {
+        const bool aliased = count != 0 && std::less_equal<const T *>()(values_.data(), data)
+                             && std::less<const T *>()(data, values_.data() + values_.size());
+        const size_t start = aliased ? static_cast<size_t>(data - values_.data()) : 0;
+        if (values_.size() + count > values_.capacity()) {
+            values_.reserve(std::max(values_.size() + count, 2 * values_.capacity()));
+        }
+        for (size_t i = 0; i < count; ++i) {
+            values_.push_back(aliased ? values_[start + i] : data[i]);
+        }
+        offsets_.push_back(values_.size());
+    }
+
+    void push_row(const Vector<T> &row) {
+        push_row(row.data(), row.size());
+    }
+
+    void push_row(std::initializer_list<T> row) {
+        push_row(row.begin(), row.size());
+    }
+
+    void push_back(const T &value) {
+        if (empty()) {
+            throw std::out_of_range("JaggedVector has no rows");
+        }
+        values_.push_back(value);
+        ++offsets_.back();
+    }
+
+    void push_back(T &&value) {
+        if (empty()) {
+            throw std::out_of_range("JaggedVector has no rows");
+        }
+        values_.push_back(std::move(value));
+        ++offsets_.back();
+    }
+};
+
+#endif //VECTOR_JAGGEDVECTOR_H
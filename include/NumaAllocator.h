@@ -0,0 +1,270 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_NUMAALLOCATOR_H
+#define VECTOR_NUMAALLOCATOR_H
+
+#include <cstddef>
+#include <cstdio>
+#include <new>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Memory policies are applied with the raw mbind/set_mempolicy system calls,
+// so libnuma is not needed. When the kernel has no NUMA support the calls
+// fail and memory silently falls back to the default first-touch placement.
+enum class NumaPolicy {
+    Default,
+    Local,
+    Interleave,
+    Bind
+};
+
+namespace numa_detail {
+    constexpr int mpol_default = 0;
+    constexpr int mpol_bind = 2;
+    constexpr int mpol_interleave = 3;
+    constexpr int mpol_local = 4;
+    constexpr int mpol_f_node = 1 << 0;
+    constexpr int mpol_f_addr = 1 << 1;
+    constexpr size_t max_nodes = 8 * sizeof(unsigned long);
+
+    inline bool parse_list(const char *path, size_t (&range)[2]) {
+        FILE *file = std::fopen(path, "r");
+        if (file == nullptr) {
+            return false;
+        }
+        unsigned long first = 0;
+        unsigned long last = 0;
+        const int read = std::fscanf(file, "%lu-%lu", &first, &last);
+        std::fclose(file);
+        if (read < 1) {
+            return false;
+        }
+        range[0] = first;
+        range[1] = read == 2 ? last : first;
+        return true;
+    }
+
+    inline size_t page_size() noexcept {
+#if defined(__linux__)
+        static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return size;
+#else
+        return 4096;
+#endif
+    }
+
+    inline void policy_arguments(NumaPolicy policy, int node, size_t nodes, int &mode, unsigned long &mask) noexcept {
+        mask = 0;
+        switch (policy) {
+            case NumaPolicy::Local:
+                mode = mpol_local;
+                break;
+            case NumaPolicy::Interleave:
+                mode = mpol_interleave;
+                for (size_t i = 0; i < nodes && i < max_nodes; ++i) {
+                    mask |= 1ul << i;
+                }
+                break;
+            case NumaPolicy::Bind:
+                mode = mpol_bind;
+                mask = 1ul << (static_cast<size_t>(node) % max_nodes);
+                break;
+            default:
+                mode = mpol_default;
+        }
+    }
+}
+
+inline size_t numa_node_count() noexcept {
+    static const size_t count = []() {
+        size_t range[2];
+        if (!numa_detail::parse_list("/sys/devices/system/node/online", range)) {
+            return size_t(1);
+        }
+        return range[1] + 1;
+    }();
+    return count;
+}
+
+// Returns false when the node's CPUs cannot be read or the affinity cannot be
+// changed; the calling thread then keeps its current affinity.
+inline bool numa_bind_current_thread(size_t node) noexcept {
+#if defined(__linux__)
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu/cpulist", node);
+    FILE *file = std::fopen(path, "r");
+    if (file == nullptr) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    unsigned long first = 0;
+    unsigned long last = 0;
+    int separator = ',';
+    while (separator == ',' && std::fscanf(file, "%lu", &first) == 1) {
+        last = first;
+        separator = std::fgetc(file);
+        if (separator == '-') {
+            if (std::fscanf(file, "%lu", &last) != 1) {
+                break;
+            }
+            separator = std::fgetc(file);
+        }
+        for (unsigned long cpu = first; cpu <= last && cpu < CPU_SETSIZE; ++cpu) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    std::fclose(file);
+    return CPU_COUNT(&cpus) > 0 && sched_setaffinity(0, sizeof(cpus), &cpus) == 0;
+#else
+    (void) node;
+    return false;
+#endif
+}
+
+// Spreads the workers of a parallel construction evenly over the nodes; use
+// as ParallelConstruct::on_start.
+inline void numa_spread_workers(size_t worker, size_t workers) noexcept {
+    const size_t nodes = numa_node_count();
+    if (nodes > 1) {
+        numa_bind_current_thread(worker * nodes / workers);
+    }
+}
+
+inline bool numa_set_thread_policy(NumaPolicy policy, int node = 0) noexcept {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+    int mode = 0;
+    unsigned long mask = 0;
+    numa_detail::policy_arguments(policy, node, numa_node_count(), mode, mask);
+    return syscall(SYS_set_mempolicy, mode, mask == 0 ? nullptr : &mask,
+                   mask == 0 ? 0 : numa_detail::max_nodes + 1) == 0;
+#else
+    (void) policy;
+    (void) node;
+    return false;
+#endif
+}
+
+// Returns the node backing the page at address, or -1 if it is unknown.
+inline int numa_node_of(const void *address) noexcept {
+#if defined(__linux__) && defined(SYS_get_mempolicy)
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address,
+                numa_detail::mpol_f_node | numa_detail::mpol_f_addr) == 0) {
+        return node;
+    }
+#else
+    (void) address;
+#endif
+    return -1;
+}
+
+// Allocations of at least one page are mapped directly and tagged with the
+// policy via mbind, so pages are placed when they are first touched rather
+// than when they are allocated. Smaller allocations use operator new, with
+// the alignment overload for over-aligned element types.
+template<typename T>
+class NumaAllocator {
+private:
+    NumaPolicy policy_;
+    int node_;
+
+    static size_t mapped_bytes(size_t n) noexcept {
+        const size_t page = numa_detail::page_size();
+        return (n * sizeof(T) + page - 1) / page * page;
+    }
+
+    static bool is_mapped(size_t n) noexcept {
+#if defined(__linux__)
+        return n * sizeof(T) >= numa_detail::page_size();
+#else
+        (void) n;
+        return false;
+#endif
+    }
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = NumaAllocator<U>;
+    };
+
+    explicit NumaAllocator(NumaPolicy policy = NumaPolicy::Local, int node = 0) noexcept
+            : policy_(policy), node_(node) {}
+
+    template<typename U>
+    NumaAllocator(const NumaAllocator<U> &rhs) noexcept : policy_(rhs.policy()), node_(rhs.node()) {}
+
+    T *allocate(size_t n) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        if (!is_mapped(n)) {
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+            } else {
+                return static_cast<T *>(::operator new(n * sizeof(T)));
+            }
+        }
+#if defined(__linux__)
+        const size_t bytes = mapped_bytes(n);
+        void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#if defined(SYS_mbind)
+        int mode = 0;
+        unsigned long mask = 0;
+        numa_detail::policy_arguments(policy_, node_, numa_node_count(), mode, mask);
+        if (mode != numa_detail::mpol_default) {
+            syscall(SYS_mbind, memory, bytes, mode, mask == 0 ? nullptr : &mask,
+                    mask == 0 ? 0 : numa_detail::max_nodes + 1, 0);
+        }
+#endif
+        return static_cast<T *>(memory);
+#else
+        return nullptr;
+#endif
+    }
+
+    void deallocate(T *pointer, size_t n) noexcept {
+        if (pointer == nullptr) {
+            return;
+        }
+        if (!is_mapped(n)) {
+            if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+                ::operator delete(pointer, std::align_val_t(alignof(T)));
+            } else {
+                ::operator delete(pointer);
+            }
+            return;
+        }
+#if defined(__linux__)
+        munmap(pointer, mapped_bytes(n));
+#endif
+    }
+
+    NumaPolicy policy() const noexcept { return policy_; }
+
+    int node() const noexcept { return node_; }
+
+    template<typename U>
+    bool operator==(const NumaAllocator<U> &rhs) const noexcept {
+        return policy_ == rhs.policy() && node_ == rhs.node();
+    }
+
+    template<typename U>
+    bool operator!=(const NumaAllocator<U> &rhs) const noexcept {
+        return !(*this == rhs);
+    }
+};
+
+#endif //VECTOR_NUMAALLOCATOR_H
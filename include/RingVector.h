@@ -0,0 +1,117 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_RINGVECTOR_H
+#define VECTOR_RINGVECTOR_H
+
+#include <stdexcept>
+#include <utility>
+
+#include <Vector.h>
+
+inline size_t ring_capacity(size_t capacity) noexcept {
+    size_t result = 1;
+    while (result < capacity) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Bounded double-ended queue over a Vector whose size is rounded up to a
+// power of two, so positions wrap with a mask instead of a division.
+template<typename T>
+class RingVector {
+private:
+    Vector<T> buffer_;
+    size_t mask_;
+    size_t head_;
+    size_t size_;
+
+    size_t slot(size_t index) const noexcept { return (head_ + index) & mask_; }
+
+    void check_not_full() const {
+        if (full()) {
+            throw std::overflow_error("RingVector is full");
+        }
+    }
+
+public:
+    explicit RingVector(size_t capacity)
+            : buffer_(ring_capacity(capacity)), mask_(buffer_.size() - 1), head_(0), size_(0) {}
+
+    const T &operator[](size_t index) const { return buffer_[slot(index)]; }
+
+    T &operator[](size_t index) { return buffer_[slot(index)]; }
+
+    const T &at(size_t index) const {
+        if (index < size_) {
+            return (*this)[index];
+        }
+        throw std::out_of_range("Index out of range");
+    }
+
+    T &at(size_t index) {
+        return const_cast<T &>(static_cast<const RingVector<T> &>(*this).at(index));
+    }
+
+    const T &front() const { return buffer_[head_]; }
+
+    T &front() { return buffer_[head_]; }
+
+    const T &back() const { return buffer_[slot(size_ - 1)]; }
+
+    T &back() { return buffer_[slot(size_ - 1)]; }
+
+    size_t size() const noexcept { return size_; }
+
+    bool empty() const noexcept { return size_ == 0; }
+
+    bool full() const noexcept { return size_ == buffer_.size(); }
+
+    size_t capacity() const noexcept { return buffer_.size(); }
+
+    void clear() {
+        while (!empty()) {
+            pop_back();
+        }
+        head_ = 0;
+    }
+
+    void push_back(const T &value) {
+        check_not_full();
+        buffer_[slot(size_)] = value;
+        ++size_;
+    }
+
+    void push_back(T &&value) {
+        check_not_full();
+        buffer_[slot(size_)] = std::move(value);
+        ++size_;
+    }
+
+    void push_front(const T &value) {
+        check_not_full();
+        head_ = (head_ - 1) & mask_;
+        buffer_[head_] = value;
+        ++size_;
+    }
+
+    void push_front(T &&value) {
+        check_not_full();
+        head_ = (head_ - 1) & mask_;
+        buffer_[head_] = std::move(value);
+        ++size_;
+    }
+
+    void pop_front() {
+        buffer_[head_] = T();
+        head_ = (head_ + 1) & mask_;
+        --size_;
+    }
+
+    void pop_back() {
+        buffer_[slot(size_ - 1)] = T();
+        --size_;
+    }
+};
+
+#endif //VECTOR_RINGVECTOR_H
@@ -0,0 +1,519 @@
+// Copyright byteihq 2021 <kotov038@gmail.com>
+
+#ifndef VECTOR_SORT_H
+#define VECTOR_SORT_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <Vector.h>
+
+// Maps a key to an unsigned integer whose order matches the key order, so
+// keys can be sorted digit by digit. Signed integers get their sign bit
+// flipped; floating point numbers get the sign bit flipped when positive and
+// every bit flipped when negative.
+template<typename Key, typename = void>
+struct RadixTraits {
+    static constexpr bool radixable = false;
+};
+
+template<typename Key>
+struct RadixTraits<Key, typename std::enable_if<std::is_integral<Key>::value && !std::is_same<Key, bool>::value>::type> {
+    static constexpr bool radixable = true;
+    using Bits = typename std::make_unsigned<Key>::type;
+
+    static Bits bits(Key key) noexcept {
+        if constexpr (std::is_signed<Key>::value) {
+            return static_cast<Bits>(key) ^ (Bits(1) << (8 * sizeof(Bits) - 1));
+        } else {
+            return key;
+        }
+    }
+};
+
+template<typename Key>
+struct RadixTraits<Key, typename std::enable_if<std::is_floating_point<Key>::value
+                                                && (sizeof(Key) == 4 || sizeof(Key) == 8)>::type> {
+    static constexpr bool radixable = true;
+    using Bits = typename std::conditional<sizeof(Key) == 4, uint32_t, uint64_t>::type;
+
+    static Bits bits(Key key) noexcept {
+        Bits value;
+        std::memcpy(&value, &key, sizeof(value));
+        const Bits sign = Bits(1) << (8 * sizeof(Bits) - 1);
+        return (value & sign) != 0 ? ~value : value | sign;
+    }
+};
+
+struct IdentityKey {
+    template<typename T>
+    const T &operator()(const T &value) const noexcept { return value; }
+};
+
+namespace sort_detail {
+    constexpr size_t radix_bits = 8;
+    constexpr size_t buckets = size_t(1) << radix_bits;
+    constexpr size_t small_sort_threshold = 256;
+    constexpr size_t insertion_sort_threshold = 24;
+    constexpr size_t ninther_threshold = 128;
+    constexpr size_t partial_insertion_sort_limit = 8;
+    constexpr size_t parallel_threshold = size_t(1) << 20;
+
+    template<typename T, typename KeyFunction>
+    using key_type = typename std::decay<decltype(std::declval<KeyFunction>()(std::declval<const T &>()))>::type;
+
+    template<typename T, typename KeyFunction>
+    constexpr bool radix_sortable() {
+        return RadixTraits<key_type<T, KeyFunction>>::radixable
+               && std::is_default_constructible<T>::value && std::is_move_assignable<T>::value;
+    }
+
+    template<typename T, typename KeyFunction>
+    auto key_bits(const T &value, const KeyFunction &key) {
+        return RadixTraits<key_type<T, KeyFunction>>::bits(key(value));
+    }
+
+    template<typename T, typename KeyFunction>
+    size_t digit(const T &value, const KeyFunction &key, size_t shift) {
+        return static_cast<size_t>(key_bits(value, key) >> shift) & (buckets - 1);
+    }
+
+    template<typename T, typename Compare>
+    void insertion_sort(T *begin, T *end, Compare &comp) {
+        if (begin == end) {
+            return;
+        }
+        for (T *current = begin + 1; current != end; ++current) {
+            T *sift = current;
+            T *sift_1 = current - 1;
+            if (comp(*sift, *sift_1)) {
+                T tmp = std::move(*sift);
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != begin && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    // Requires an element not greater than any in [begin, end) at begin[-1].
+    template<typename T, typename Compare>
+    void unguarded_insertion_sort(T *begin, T *end, Compare &comp) {
+        if (begin == end) {
+            return;
+        }
+        for (T *current = begin + 1; current != end; ++current) {
+            T *sift = current;
+            T *sift_1 = current - 1;
+            if (comp(*sift, *sift_1)) {
+                T tmp = std::move(*sift);
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    // Gives up and returns false once more than a few elements had to move.
+    template<typename T, typename Compare>
+    bool partial_insertion_sort(T *begin, T *end, Compare &comp) {
+        if (begin == end) {
+            return true;
+        }
+        size_t moved = 0;
+        for (T *current = begin + 1; current != end; ++current) {
+            T *sift = current;
+            T *sift_1 = current - 1;
+            if (comp(*sift, *sift_1)) {
+                T tmp = std::move(*sift);
+                do {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != begin && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+                moved += static_cast<size_t>(current - sift);
+            }
+            if (moved > partial_insertion_sort_limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<typename T, typename Compare>
+    void sort2(T *a, T *b, Compare &comp) {
+        if (comp(*b, *a)) {
+            std::iter_swap(a, b);
+        }
+    }
+
+    template<typename T, typename Compare>
+    void sort3(T *a, T *b, T *c, Compare &comp) {
+        sort2(a, b, comp);
+        sort2(b, c, comp);
+        sort2(a, b, comp);
+    }
+
+    // Partitions around *begin; elements equal to the pivot go right. Returns
+    // the pivot position and whether the range was already partitioned.
+    template<typename T, typename Compare>
+    std::pair<T *, bool> partition_right(T *begin, T *end, Compare &comp) {
+        T pivot(std::move(*begin));
+        T *first = begin;
+        T *last = end;
+        while (comp(*++first, pivot)) {}
+        if (first - 1 == begin) {
+            while (first < last && !comp(*--last, pivot)) {}
+        } else {
+            while (!comp(*--last, pivot)) {}
+        }
+        const bool already_partitioned = first >= last;
+        while (first < last) {
+            std::iter_swap(first, last);
+            while (comp(*++first, pivot)) {}
+            while (!comp(*--last, pivot)) {}
+        }
+        T *pivot_position = first - 1;
+        *begin = std::move(*pivot_position);
+        *pivot_position = std::move(pivot);
+        return std::make_pair(pivot_position, already_partitioned);
+    }
+
+    // Partitions around *begin with equal elements going left; used when the
+    // pivot equals the element preceding the range, which puts all copies of
+    // it in place at once.
+    template<typename T, typename Compare>
+    T *partition_left(T *begin, T *end, Compare &comp) {
+        T pivot(std::move(*begin));
+        T *first = begin;
+        T *last = end;
+        while (comp(pivot, *--last)) {}
+        if (last + 1 == end) {
+            while (first < last && !comp(pivot, *++first)) {}
+        } else {
+            while (!comp(pivot, *++first)) {}
+        }
+        while (first < last) {
+            std::iter_swap(first, last);
+            while (comp(pivot, *--last)) {}
+            while (!comp(pivot, *++first)) {}
+        }
+        T *pivot_position = last;
+        *begin = std::move(*pivot_position);
+        *pivot_position = std::move(pivot);
+        return pivot_position;
+    }
+
+    template<typename T, typename Compare>
+    void pdq_sort_loop(T *begin, T *end, Compare &comp, size_t bad_allowed, bool leftmost) {
+        for (;;) {
+            const auto size = static_cast<size_t>(end - begin);
+            if (size < insertion_sort_threshold) {
+                if (leftmost) {
+                    insertion_sort(begin, end, comp);
+                } else {
+                    unguarded_insertion_sort(begin, end, comp);
+                }
+                return;
+            }
+
+            const size_t half = size / 2;
+            if (size > ninther_threshold) {
+                sort3(begin, begin + half, end - 1, comp);
+                sort3(begin + 1, begin + (half - 1), end - 2, comp);
+                sort3(begin + 2, begin + (half + 1), end - 3, comp);
+                sort3(begin + (half - 1), begin + half, begin + (half + 1), comp);
+                std::iter_swap(begin, begin + half);
+            } else {
+                sort3(begin + half, begin, end - 1, comp);
+            }
+
+            if (!leftmost && !comp(*(begin - 1), *begin)) {
+                begin = partition_left(begin, end, comp) + 1;
+                continue;
+            }
+
+            const auto partition = partition_right(begin, end, comp);
+            T *pivot_position = partition.first;
+            const auto left_size = static_cast<size_t>(pivot_position - begin);
+            const auto right_size = static_cast<size_t>(end - (pivot_position + 1));
+
+            if (left_size < size / 8 || right_size < size / 8) {
+                if (--bad_allowed == 0) {
+                    std::make_heap(begin, end, comp);
+                    std::sort_heap(begin, end, comp);
+                    return;
+                }
+                if (left_size >= insertion_sort_threshold) {
+                    std::iter_swap(begin, begin + left_size / 4);
+                    std::iter_swap(pivot_position - 1, pivot_position - left_size / 4);
+                    if (left_size > ninther_threshold) {
+                        std::iter_swap(begin + 1, begin + (left_size / 4 + 1));
+                        std::iter_swap(begin + 2, begin + (left_size / 4 + 2));
+                        std::iter_swap(pivot_position - 2, pivot_position - (left_size / 4 + 1));
+                        std::iter_swap(pivot_position - 3, pivot_position - (left_size / 4 + 2));
+                    }
+                }
+                if (right_size >= insertion_sort_threshold) {
+                    std::iter_swap(pivot_position + 1, pivot_position + (1 + right_size / 4));
+                    std::iter_swap(end - 1, end - right_size / 4);
+                    if (right_size > ninther_threshold) {
+                        std::iter_swap(pivot_position + 2, pivot_position + (2 + right_size / 4));
+                        std::iter_swap(pivot_position + 3, pivot_position + (3 + right_size / 4));
+                        std::iter_swap(end - 2, end - (1 + right_size / 4));
+                        std::iter_swap(end - 3, end - (2 + right_size / 4));
+                    }
+                }
+            } else if (partition.second && partial_insertion_sort(begin, pivot_position, comp)
+                       && partial_insertion_sort(pivot_position + 1, end, comp)) {
+                return;
+            }
+
+            pdq_sort_loop(begin, pivot_position, comp, bad_allowed, leftmost);
+            begin = pivot_position + 1;
+            leftmost = false;
+        }
+    }
+
+    template<typename T, typename Compare>
+    void pdq_sort(T *begin, T *end, Compare comp) {
+        if (end - begin < 2) {
+            return;
+        }
+        size_t bad_allowed = 0;
+        for (auto size = static_cast<size_t>(end - begin); size > 1; size >>= 1) {
+            ++bad_allowed;
+        }
+        pdq_sort_loop(begin, end, comp, bad_allowed, true);
+    }
+
+    // Radixable keys are compared by their radix bits, so small inputs that
+    // skip the radix passes order NaN and -0.0 exactly like large ones.
+    template<typename T, typename KeyFunction>
+    void pdq_sort_by_key(T *begin, T *end, const KeyFunction &key) {
+        if constexpr (RadixTraits<key_type<T, KeyFunction>>::radixable) {
+            pdq_sort(begin, end, [&key](const T &lhs, const T &rhs) {
+                return key_bits(lhs, key) < key_bits(rhs, key);
+            });
+        } else {
+            pdq_sort(begin, end, [&key](const T &lhs, const T &rhs) { return key(lhs) < key(rhs); });
+        }
+    }
+
+    // Stable counterpart of pdq_sort_by_key for inputs below
+    // small_sort_threshold, where quadratic insertion sort is still cheap.
+    template<typename T, typename KeyFunction>
+    void insertion_sort_by_key(T *begin, T *end, const KeyFunction &key) {
+        auto comp = [&key](const T &lhs, const T &rhs) { return key_bits(lhs, key) < key_bits(rhs, key); };
+        insertion_sort(begin, end, comp);
+    }
+
+    template<typename T, typename KeyFunction>
+    void lsd_radix_sort(T *data, size_t size, const KeyFunction &key) {
+        using Bits = typename RadixTraits<key_type<T, KeyFunction>>::Bits;
+        constexpr size_t passes = sizeof(Bits);
+
+        size_t counts[passes][buckets] = {};
+        for (size_t i = 0; i < size; ++i) {
+            const Bits bits = key_bits(data[i], key);
+            for (size_t pass = 0; pass < passes; ++pass) {
+                ++counts[pass][static_cast<size_t>(bits >> (pass * radix_bits)) & (buckets - 1)];
+            }
+        }
+
+        Vector<T> scratch(size);
+        T *from = data;
+        T *to = scratch.data();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            size_t *count = counts[pass];
+            if (count[digit(from[0], key, pass * radix_bits)] == size) {
+                continue;
+            }
+            size_t offset = 0;
+            for (size_t bucket = 0; bucket < buckets; ++bucket) {
+                const size_t bucket_size = count[bucket];
+                count[bucket] = offset;
+                offset += bucket_size;
+            }
+            for (size_t i = 0; i < size; ++i) {
+                to[count[digit(from[i], key, pass * radix_bits)]++] = std::move(from[i]);
+            }
+            std::swap(from, to);
+        }
+        if (from != data) {
+            std::move(from, from + size, data);
+        }
+    }
+
+    // American flag sort: buckets are permuted in place by following cycles,
+    // then each bucket is sorted on the next digit.
+    template<typename T, typename KeyFunction>
+    void msd_radix_sort(T *data, size_t size, const KeyFunction &key, size_t shift) {
+        if (size < small_sort_threshold) {
+            pdq_sort_by_key(data, data + size, key);
+            return;
+        }
+        size_t head[buckets] = {};
+        size_t tail[buckets];
+        for (size_t i = 0; i < size; ++i) {
+            ++head[digit(data[i], key, shift)];
+        }
+        size_t offset = 0;
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            const size_t bucket_size = head[bucket];
+            head[bucket] = offset;
+            offset += bucket_size;
+            tail[bucket] = offset;
+        }
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            while (head[bucket] < tail[bucket]) {
+                T value = std::move(data[head[bucket]]);
+                size_t value_bucket = digit(value, key, shift);
+                while (value_bucket != bucket) {
+                    std::swap(value, data[head[value_bucket]++]);
+                    value_bucket = digit(value, key, shift);
+                }
+                data[head[bucket]++] = std::move(value);
+            }
+        }
+        if (shift == 0) {
+            return;
+        }
+        size_t begin = 0;
+        for (size_t bucket = 0; bucket < buckets; ++bucket) {
+            msd_radix_sort(data + begin, tail[bucket] - begin, key, shift - radix_bits);
+            begin = tail[bucket];
+        }
+    }
+
+    template<typename Function>
+    void run_parallel(size_t threads, const Function &function) {
+        std::unique_ptr<std::thread[]> workers(new std::thread[threads - 1]);
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers[worker - 1] = std::thread(function, worker);
+        }
+        function(0);
+        for (size_t worker = 1; worker < threads; ++worker) {
+            workers[worker - 1].join();
+        }
+    }
+
+    // Every worker counts the digits of its own chunk; a worker's share of a
+    // bucket starts after the shares of all earlier workers, which keeps the
+    // scatter stable without any synchronisation between workers.
+    template<typename T, typename KeyFunction>
+    void parallel_lsd_radix_sort(T *data, size_t size, const KeyFunction &key, size_t threads) {
+        using Bits = typename RadixTraits<key_type<T, KeyFunction>>::Bits;
+        constexpr size_t passes = sizeof(Bits);
+
+        std::unique_ptr<size_t[]> counts(new size_t[threads * buckets]);
+        Vector<T> scratch(size);
+        T *from = data;
+        T *to = scratch.data();
+        for (size_t pass = 0; pass < passes; ++pass) {
+            const size_t shift = pass * radix_bits;
+            run_parallel(threads, [&](size_t worker) {
+                size_t *count = counts.get() + worker * buckets;
+                std::fill(count, count + buckets, 0);
+                for (size_t i = size * worker / threads; i < size * (worker + 1) / threads; ++i) {
+                    ++count[digit(from[i], key, shift)];
+                }
+            });
+            size_t offset = 0;
+            bool trivial = false;
+            for (size_t bucket = 0; bucket < buckets; ++bucket) {
+                const size_t start = offset;
+                for (size_t worker = 0; worker < threads; ++worker) {
+                    const size_t bucket_size = counts[worker * buckets + bucket];
+                    counts[worker * buckets + bucket] = offset;
+                    offset += bucket_size;
+                }
+                trivial = trivial || offset - start == size;
+            }
+            if (trivial) {
+                continue;
+            }
+            run_parallel(threads, [&](size_t worker) {
+                size_t *count = counts.get() + worker * buckets;
+                for (size_t i = size * worker / threads; i < size * (worker + 1) / threads; ++i) {
+                    to[count[digit(from[i], key, shift)]++] = std::move(from[i]);
+                }
+            });
+            std::swap(from, to);
+        }
+        if (from != data) {
+            run_parallel(threads, [&](size_t worker) {
+                std::move(from + size * worker / threads, from + size * (worker + 1) / threads,
+                          data + size * worker / threads);
+            });
+        }
+    }
+}
+
+template<typename T, typename Allocator, typename Compare = std::less<T>>
+void pdq_sort(Vector<T, Allocator> &vec, Compare comp = Compare()) {
+    sort_detail::pdq_sort(vec.data(), vec.data() + vec.size(), comp);
+}
+
+// Stable LSD radix sort; needs a scratch buffer of the same size.
+template<typename T, typename Allocator, typename KeyFunction = IdentityKey>
+void radix_sort(Vector<T, Allocator> &vec, KeyFunction key = KeyFunction()) {
+    static_assert(sort_detail::radix_sortable<T, KeyFunction>(), "radix_sort requires an integral or floating point key");
+    if (vec.size() < sort_detail::small_sort_threshold) {
+        sort_detail::insertion_sort_by_key(vec.data(), vec.data() + vec.size(), key);
+        return;
+    }
+    sort_detail::lsd_radix_sort(vec.data(), vec.size(), key);
+}
+
+// In-place MSD radix sort; not stable, but needs no scratch buffer.
+template<typename T, typename Allocator, typename KeyFunction = IdentityKey>
+void msd_radix_sort(Vector<T, Allocator> &vec, KeyFunction key = KeyFunction()) {
+    static_assert(RadixTraits<sort_detail::key_type<T, KeyFunction>>::radixable,
+                  "msd_radix_sort requires an integral or floating point key");
+    using Bits = typename RadixTraits<sort_detail::key_type<T, KeyFunction>>::Bits;
+    sort_detail::msd_radix_sort(vec.data(), vec.size(), key, (sizeof(Bits) - 1) * sort_detail::radix_bits);
+}
+
+// Stable LSD radix sort with every pass split over threads (0 means one per
+// hardware thread).
+template<typename T, typename Allocator, typename KeyFunction = IdentityKey>
+void parallel_radix_sort(Vector<T, Allocator> &vec, KeyFunction key = KeyFunction(), size_t threads = 0) {
+    static_assert(sort_detail::radix_sortable<T, KeyFunction>(),
+                  "parallel_radix_sort requires an integral or floating point key");
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min(threads, vec.size() / sort_detail::small_sort_threshold);
+    if (threads <= 1) {
+        radix_sort(vec, key);
+        return;
+    }
+    sort_detail::parallel_lsd_radix_sort(vec.data(), vec.size(), key, threads);
+}
+
+// Sorts by key, choosing the algorithm: radix sort for integral and floating
+// point keys (on several threads for large vectors), pdqsort for small
+// vectors and for keys radix sort cannot handle.
+template<typename T, typename Allocator, typename KeyFunction = IdentityKey>
+void sort_vector(Vector<T, Allocator> &vec, KeyFunction key = KeyFunction()) {
+    if constexpr (sort_detail::radix_sortable<T, KeyFunction>()) {
+        if (vec.size() >= sort_detail::parallel_threshold) {
+            parallel_radix_sort(vec, key);
+        } else if (vec.size() >= sort_detail::small_sort_threshold) {
+            sort_detail::lsd_radix_sort(vec.data(), vec.size(), key);
+        } else {
+            sort_detail::pdq_sort_by_key(vec.data(), vec.data() + vec.size(), key);
+        }
+    } else {
+        sort_detail::pdq_sort_by_key(vec.data(), vec.data() + vec.size(), key);
+    }
+}
+
+#endif //VECTOR_SORT_H
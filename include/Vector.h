@@ -6,11 +6,23 @@
 #include <algorithm>
 #include <stdexcept>
 #include <utility>
+#include <exception>
 #include <memory>
+#include <thread>
 
 #include <Iterator.h>
 #include <Reverse_iterator.h>
 
+// Requests that Vector(size, value, ParallelConstruct) construct its elements
+// on several threads, each worker building one contiguous partition. With an
+// allocator that does not touch memory on allocation the pages of every
+// partition are then first touched by the worker that owns it. on_start, if
+// set, runs on each worker thread before it starts (e.g. to pin it to a node).
+struct ParallelConstruct {
+    size_t threads = 0;
+    void (*on_start)(size_t worker, size_t workers) = nullptr;
+};
+
 template<typename T, typename Allocator = std::allocator<T>>
 class Vector {
 private:
@@ -82,6 +94,67 @@ public:
         try_construct(0, size_, capacity_, data_, value);
     }
 
+    Vector(size_t _size, const T &value, const ParallelConstruct &parallel, const Allocator &allocator = Allocator())
+            : size_(_size), capacity_(_size), allocator_(allocator) {
+        data_ = AllocTraits::allocate(allocator_, size_);
+        size_t workers = parallel.threads != 0 ? parallel.threads : std::thread::hardware_concurrency();
+        workers = std::max<size_t>(1, std::min(workers, size_));
+        if (workers == 1) {
+            try_construct(0, size_, capacity_, data_, value);
+            return;
+        }
+        std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[workers]);
+        std::unique_ptr<std::thread[]> threads(new std::thread[workers]);
+        auto construct = [this, &value, &parallel, &errors, workers](size_t worker) {
+            if (parallel.on_start != nullptr) {
+                parallel.on_start(worker, workers);
+            }
+            const size_t first = size_ * worker / workers;
+            const size_t last = size_ * (worker + 1) / workers;
+            size_t i = first;
+            try {
+                for (; i < last; ++i) {
+                    AllocTraits::construct(allocator_, data_ + i, value);
+                }
+            } catch (...) {
+                for (size_t j = first; j < i; ++j) {
+                    AllocTraits::destroy(allocator_, data_ + j);
+                }
+                errors[worker] = std::current_exception();
+            }
+        };
+        size_t started = 0;
+        try {
+            for (; started < workers; ++started) {
+                threads[started] = std::thread(construct, started);
+            }
+        } catch (...) {
+            for (size_t worker = started; worker < workers; ++worker) {
+                errors[worker] = std::current_exception();
+            }
+        }
+        for (size_t worker = 0; worker < started; ++worker) {
+            threads[worker].join();
+        }
+        std::exception_ptr error;
+        for (size_t worker = 0; worker < workers; ++worker) {
+            if (error == nullptr && errors[worker] != nullptr) {
+                error = errors[worker];
+            }
+        }
+        if (error != nullptr) {
+            for (size_t worker = 0; worker < workers; ++worker) {
+                if (errors[worker] == nullptr) {
+                    for (size_t i = size_ * worker / workers; i < size_ * (worker + 1) / workers; ++i) {
+                        AllocTraits::destroy(allocator_, data_ + i);
+                    }
+                }
+            }
+            AllocTraits::deallocate(allocator_, data_, capacity_);
+            std::rethrow_exception(error);
+        }
+    }
+
     Vector(size_t _size, const T *_data)
             : data_(AllocTraits::allocate(allocator_, _size)), size_(_size), capacity_(_size) {
         std::copy(_data, _data + _size, data_);
@@ -95,16 +168,18 @@ public:
         try_construct(0, size_, capacity_, data_, rhs.data_);
     }
 
-    Vector(Vector &&rhs) noexcept: data_(rhs.data_), size_(rhs.size_), capacity_(rhs.capacity_) {
+    Vector(Vector &&rhs) noexcept
+            : data_(rhs.data_),
+              size_(rhs.size_),
+              capacity_(rhs.capacity_),
+              allocator_(std::move(rhs.allocator_)) {
         rhs.data_ = nullptr;
         rhs.size_ = 0;
         rhs.capacity_ = 0;
     }
 
     ~Vector() {
-        for (size_t i = 0; i < size_; ++i) {
-            pop_back();
-        }
+        clear();
         AllocTraits::deallocate(allocator_, data_, capacity_);
     }
 
@@ -150,7 +225,7 @@ public:
     }
 
     T &at(size_t index) {
-        return const_cast<T &>(static_cast<const Vector<T> &>(*this).at(index));
+        return const_cast<T &>(static_cast<const Vector &>(*this).at(index));
     }
 
     const T &front() const { return data_[0]; }
@@ -210,26 +285,29 @@ public:
         if (position >= Iterator(data_ + size_)) {
             throw std::out_of_range("Iterator out of range");
         }
+        size_t new_capacity = capacity_;
         if (capacity_ == size_) {
-            if (capacity_ == 0) ++capacity_;
-            capacity_ *= 2;
+            if (new_capacity == 0) ++new_capacity;
+            new_capacity *= 2;
         }
-        T *tmp = AllocTraits::allocate(allocator_, capacity_);
+        T *tmp = AllocTraits::allocate(allocator_, new_capacity);
         auto distance = static_cast<size_t>(std::distance(begin(), position));
-        try_construct(0, distance, capacity_, tmp, data_);
+        try_construct(0, distance, new_capacity, tmp, data_);
         AllocTraits::construct(allocator_, tmp + distance, value);
-        try_construct(distance + 1, size_, capacity_, tmp, data_);
+        try_construct(distance + 1, size_, new_capacity, tmp, data_);
         for (size_t i = 0; i < size_; ++i) {
             AllocTraits::destroy(allocator_, data_ + i);
         }
         AllocTraits::deallocate(allocator_, data_, capacity_);
         data_ = tmp;
+        capacity_ = new_capacity;
         ++size_;
         return Iterator(data_ + distance);
     }
 
     constexpr void push_back(const T &value) {
         if (capacity_ == size_) {
+            if (capacity_ == 0) ++capacity_;
             reserve(2 * capacity_);
         }
         AllocTraits::construct(allocator_, data_ + size_, value);
@@ -255,13 +333,16 @@ public:
         --size_;
     }
 
-    constexpr void swap(Vector<T> &rhs) {
+    constexpr void swap(Vector &rhs) {
         std::swap(data_, rhs.data_);
         std::swap(size_, rhs.size_);
         std::swap(capacity_, rhs.capacity_);
+        std::swap(allocator_, rhs.allocator_);
     }
 
-    constexpr bool operator==(const Vector<T> &rhs) const {
+    Allocator get_allocator() const { return allocator_; }
+
+    constexpr bool operator==(const Vector &rhs) const {
         if (size_ != rhs.size_) {
             return false;
         }
@@ -274,8 +355,8 @@ public:
     }
 };
 
-template<typename T>
-constexpr bool operator!=(const Vector<T> &lhs, const Vector<T> &rhs) {
+template<typename T, typename Allocator>
+constexpr bool operator!=(const Vector<T, Allocator> &lhs, const Vector<T, Allocator> &rhs) {
     return !(lhs == rhs);
 }
 
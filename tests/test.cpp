@@ -2,7 +2,21 @@
 
 #include <gtest/gtest.h>
 #include <Vector.h>
+#include <CompressedIntVector.h>
+#include <ConcurrentQueue.h>
+#include <Ingest.h>
+#include <JaggedVector.h>
+#include <NumaAllocator.h>
+#include <RingVector.h>
+#include <Sort.h>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <thread>
 #include <type_traits>
 
 TEST(Vector, CopyAndMoveAssignable) {
@@ -290,3 +304,696 @@ TEST(Vector, Swap) {
     EXPECT_TRUE(i_vec1.empty());
     EXPECT_EQ(i_vec2.size(), 2);
 }
+
+TEST(Vector, PushBackCopyIntoEmpty) {
+    Vector<std::string> vec;
+    const std::string value = "value";
+    vec.push_back(value);
+    EXPECT_EQ(vec.size(), 1);
+    EXPECT_EQ(vec.front(), "value");
+}
+
+TEST(CompressedIntVector, SortedRoundTrip) {
+    Vector<uint32_t> ids;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        ids.push_back(1000000 + i * 3);
+    }
+    CompressedIntVector<uint32_t> compressed(ids);
+    EXPECT_EQ(compressed.size(), ids.size());
+    EXPECT_EQ(compressed.block_count(), 8);
+    EXPECT_LT(compressed.memory_bytes(), ids.size() * sizeof(uint32_t) / 4);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        EXPECT_EQ(compressed[i], ids[i]);
+    }
+    EXPECT_TRUE(compressed.to_vector() == ids);
+}
+
+TEST(CompressedIntVector, DeltaRandomAccess) {
+    Vector<uint64_t> ids;
+    uint64_t id = uint64_t(1) << 40;
+    for (uint64_t i = 0; i < 512; ++i) {
+        id += (i * 7919) % 61;
+        ids.push_back(id);
+    }
+    const CompressedIntVector<uint64_t> compressed(ids);
+    for (size_t i = ids.size(); i > 0; --i) {
+        EXPECT_EQ(compressed[i - 1], ids[i - 1]);
+    }
+}
+
+TEST(CompressedIntVector, ConstantBlocks) {
+    CompressedIntVector<uint32_t> constant;
+    for (size_t i = 0; i < 128; ++i) {
+        constant.push_back(7);
+    }
+    EXPECT_EQ(constant[5], 7);
+    EXPECT_EQ(constant.at(127), 7);
+
+    Vector<uint64_t> values;
+    for (uint64_t i = 0; i < 256; ++i) {
+        values.push_back(i * i);
+    }
+    for (size_t i = 0; i < 128; ++i) {
+        values.push_back(0);
+    }
+    const CompressedIntVector<uint64_t> compressed(values);
+    EXPECT_EQ(compressed.block_count(), 3);
+    for (size_t i = values.size(); i > 0; --i) {
+        EXPECT_EQ(compressed[i - 1], values[i - 1]);
+    }
+    EXPECT_TRUE(compressed.to_vector() == values);
+}
+
+TEST(CompressedIntVector, UnsortedRoundTrip) {
+    Vector<uint32_t> counters;
+    uint32_t state = 12345;
+    for (size_t i = 0; i < 777; ++i) {
+        state = state * 1103515245u + 12345u;
+        counters.push_back((state >> 16) % 1000);
+    }
+    CompressedIntVector<uint32_t> compressed(counters);
+    size_t index = 0;
+    for (auto value : compressed) {
+        EXPECT_EQ(value, counters[index]);
+        ++index;
+    }
+    EXPECT_EQ(index, counters.size());
+    EXPECT_EQ(compressed.at(776), counters[776]);
+    EXPECT_THROW(compressed.at(777), std::out_of_range);
+}
+
+TEST(CompressedIntVector, WideValues) {
+    CompressedIntVector<uint64_t> compressed;
+    EXPECT_TRUE(compressed.empty());
+    Vector<uint64_t> values;
+    for (uint64_t i = 0; i < 300; ++i) {
+        const uint64_t value = (i % 2 == 0) ? i : (uint64_t(1) << 63) + i * 7;
+        values.push_back(value);
+        compressed.push_back(value);
+    }
+    for (uint64_t i = 0; i < 130; ++i) {
+        values.push_back(uint64_t(1) << 40);
+        compressed.push_back(uint64_t(1) << 40);
+    }
+    EXPECT_EQ(compressed.size(), values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(compressed[i], values[i]);
+    }
+    EXPECT_TRUE(compressed.to_vector() == values);
+}
+
+TEST(RingVector, PushPopBothEnds) {
+    RingVector<std::string> ring(3);
+    EXPECT_EQ(ring.capacity(), 4);
+    EXPECT_TRUE(ring.empty());
+    ring.push_back("b");
+    ring.push_back("c");
+    ring.push_front("a");
+    EXPECT_EQ(ring.size(), 3);
+    EXPECT_EQ(ring.front(), "a");
+    EXPECT_EQ(ring.back(), "c");
+    EXPECT_EQ(ring[1], "b");
+    ring.push_front("z");
+    EXPECT_TRUE(ring.full());
+    EXPECT_THROW(ring.push_back("d"), std::overflow_error);
+    EXPECT_EQ(ring.at(0), "z");
+    EXPECT_THROW(ring.at(4), std::out_of_range);
+    ring.pop_back();
+    ring.pop_front();
+    EXPECT_EQ(ring.front(), "a");
+    EXPECT_EQ(ring.back(), "b");
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST(RingVector, Wraparound) {
+    RingVector<int> ring(8);
+    for (int i = 0; i < 100; ++i) {
+        ring.push_back(i);
+        if (ring.size() == 5) {
+            EXPECT_EQ(ring.front(), i - 4);
+            ring.pop_front();
+        }
+    }
+    EXPECT_EQ(ring.size(), 4);
+    EXPECT_EQ(ring.front(), 96);
+    EXPECT_EQ(ring.back(), 99);
+}
+
+TEST(SPSCQueue, Batch) {
+    SPSCQueue<int> queue(4);
+    const int data[] = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(queue.push_batch(data, 6), 4);
+    EXPECT_FALSE(queue.try_push(7));
+    int out[6] = {};
+    EXPECT_EQ(queue.pop_batch(out, 3), 3);
+    EXPECT_EQ(out[2], 3);
+    int value = 0;
+    EXPECT_TRUE(queue.try_pop(value));
+    EXPECT_EQ(value, 4);
+    EXPECT_FALSE(queue.try_pop(value));
+}
+
+TEST(SPSCQueue, ProducerConsumer) {
+    SPSCQueue<size_t> queue(64);
+    const size_t count = 100000;
+    std::thread producer([&queue]() {
+        for (size_t i = 0; i < count; ++i) {
+            while (!queue.try_push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+    size_t expected = 0;
+    size_t value = 0;
+    while (expected < count) {
+        if (queue.try_pop(value)) {
+            ASSERT_EQ(value, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+}
+
+TEST(MPMCQueue, ProducersConsumers) {
+    MPMCQueue<size_t> queue(128);
+    constexpr size_t threads = 3;
+    constexpr size_t per_thread = 20000;
+    std::atomic<size_t> sum(0);
+    std::atomic<size_t> popped(0);
+    std::thread workers[2 * threads];
+    for (size_t t = 0; t < threads; ++t) {
+        workers[2 * t] = std::thread([&queue, t]() {
+            size_t batch[16];
+            for (size_t i = 0; i < per_thread;) {
+                size_t count = 0;
+                for (; count < 16 && i + count < per_thread; ++count) {
+                    batch[count] = t * per_thread + i + count + 1;
+                }
+                size_t pushed = 0;
+                if (t % 2 == 0) {
+                    pushed = queue.push_batch(batch, count);
+                } else if (queue.try_push(batch[0])) {
+                    pushed = 1;
+                }
+                if (pushed == 0) {
+                    std::this_thread::yield();
+                }
+                i += pushed;
+            }
+        });
+        workers[2 * t + 1] = std::thread([&queue, &sum, &popped, t]() {
+            size_t batch[16];
+            while (popped.load() < threads * per_thread) {
+                size_t count = 0;
+                if (t % 2 == 0) {
+                    count = queue.pop_batch(batch, 16);
+                } else if (queue.try_pop(batch[0])) {
+                    count = 1;
+                }
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+                for (size_t i = 0; i < count; ++i) {
+                    sum += batch[i];
+                }
+                popped += count;
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    const size_t total = threads * per_thread;
+    EXPECT_EQ(popped.load(), total);
+    EXPECT_EQ(sum.load(), total * (total + 1) / 2);
+    EXPECT_EQ(queue.size_approx(), 0);
+}
+
+TEST(Vector, InsertKeepsCapacityConsistent) {
+    Vector<int, NumaAllocator<int>> vec(2048, 1);
+    auto it = vec.begin();
+    it = vec.insert(it, 2);
+    EXPECT_EQ(vec.front(), 2);
+    EXPECT_EQ(vec.capacity(), 4096);
+}
+
+TEST(Vector, ParallelConstruct) {
+    ParallelConstruct parallel;
+    parallel.threads = 4;
+    Vector<std::string> vec(1001, "value", parallel);
+    EXPECT_EQ(vec.size(), 1001);
+    EXPECT_EQ(vec.capacity(), 1001);
+    for (size_t i = 0; i < vec.size(); ++i) {
+        EXPECT_EQ(vec[i], "value");
+    }
+    Vector<int> small(2, 7, parallel);
+    EXPECT_EQ(small.size(), 2);
+    EXPECT_EQ(small[1], 7);
+}
+
+class ThrowingCopy {
+private:
+    static std::atomic<size_t> copies_;
+    static std::atomic<size_t> alive_;
+    static size_t throw_at_;
+
+public:
+    ThrowingCopy() { ++alive_; }
+
+    ThrowingCopy(const ThrowingCopy &) {
+        if (++copies_ == throw_at_) {
+            throw std::runtime_error("copy failed");
+        }
+        ++alive_;
+    }
+
+    ~ThrowingCopy() { --alive_; }
+
+    static size_t alive() { return alive_.load(); }
+
+    // Makes the throw_at-th copy from now on throw; 0 disables throwing.
+    static void reset(size_t throw_at) {
+        copies_ = 0;
+        throw_at_ = throw_at;
+    }
+};
+
+std::atomic<size_t> ThrowingCopy::copies_(0);
+std::atomic<size_t> ThrowingCopy::alive_(0);
+size_t ThrowingCopy::throw_at_ = 0;
+
+TEST(Vector, ParallelConstructRollsBack) {
+    ParallelConstruct parallel;
+    parallel.threads = 3;
+    ASSERT_EQ(ThrowingCopy::alive(), 0);
+    ThrowingCopy::reset(700);
+    {
+        const ThrowingCopy value;
+        EXPECT_THROW(Vector<ThrowingCopy>(1000, value, parallel), std::runtime_error);
+        EXPECT_EQ(ThrowingCopy::alive(), 1);
+    }
+    EXPECT_EQ(ThrowingCopy::alive(), 0);
+    ThrowingCopy::reset(0);
+}
+
+TEST(NumaAllocator, Policies) {
+    EXPECT_GE(numa_node_count(), 1);
+    const NumaPolicy policies[] = {NumaPolicy::Default, NumaPolicy::Local, NumaPolicy::Interleave, NumaPolicy::Bind};
+    ParallelConstruct parallel;
+    parallel.threads = 2;
+    parallel.on_start = numa_spread_workers;
+    for (auto policy : policies) {
+        NumaAllocator<uint64_t> allocator(policy);
+        Vector<uint64_t, NumaAllocator<uint64_t>> vec(1 << 16, 3, parallel, allocator);
+        EXPECT_EQ(vec[0], 3);
+        EXPECT_EQ(vec[(1 << 16) - 1], 3);
+        const int node = numa_node_of(vec.data());
+        if (numa_node_count() > 1) {
+            ASSERT_GE(node, 0);
+        }
+        if (node >= 0) {
+            EXPECT_LT(static_cast<size_t>(node), numa_node_count());
+            if (policy == NumaPolicy::Bind) {
+                EXPECT_EQ(node, 0);
+            }
+        }
+        Vector<uint64_t, NumaAllocator<uint64_t>> small(3, 5, allocator);
+        EXPECT_EQ(small[2], 5);
+    }
+    EXPECT_TRUE(NumaAllocator<int>(NumaPolicy::Bind, 0) == NumaAllocator<double>(NumaPolicy::Bind, 0));
+    EXPECT_TRUE(NumaAllocator<int>(NumaPolicy::Bind, 0) != NumaAllocator<int>(NumaPolicy::Interleave));
+}
+
+struct alignas(64) CacheLinePadded {
+    uint64_t value = 0;
+};
+
+TEST(NumaAllocator, OverAlignedElements) {
+    NumaAllocator<CacheLinePadded> allocator;
+    CacheLinePadded *small = allocator.allocate(3);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(small) % alignof(CacheLinePadded), 0);
+    allocator.deallocate(small, 3);
+    Vector<CacheLinePadded, NumaAllocator<CacheLinePadded>> vec(5, CacheLinePadded(), allocator);
+    for (size_t i = 0; i < 20; ++i) {
+        vec.push_back(CacheLinePadded());
+    }
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(vec.data()) % alignof(CacheLinePadded), 0);
+}
+
+TEST(NumaAllocator, VectorInterface) {
+    using NumaVector = Vector<int, NumaAllocator<int>>;
+    const NumaAllocator<int> interleave(NumaPolicy::Interleave);
+    NumaVector first(3, 1, interleave);
+    NumaVector second(2, 2, NumaAllocator<int>(NumaPolicy::Bind, 0));
+    first.at(1) = 7;
+    EXPECT_EQ(first.at(1), 7);
+    EXPECT_THROW(first.at(3), std::out_of_range);
+
+    first.swap(second);
+    EXPECT_EQ(first.size(), 2);
+    EXPECT_EQ(first.get_allocator().policy(), NumaPolicy::Bind);
+    EXPECT_EQ(second.at(1), 7);
+    EXPECT_EQ(second.get_allocator().policy(), NumaPolicy::Interleave);
+
+    NumaVector copy(second);
+    EXPECT_TRUE(copy == second);
+    EXPECT_TRUE(copy != first);
+
+    NumaVector moved(std::move(second));
+    EXPECT_EQ(moved.get_allocator(), interleave);
+    EXPECT_EQ(moved.at(1), 7);
+}
+
+template<typename T>
+Vector<T> random_values(size_t count, uint64_t seed) {
+    Vector<T> values;
+    values.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        values.push_back(static_cast<T>(seed));
+    }
+    return values;
+}
+
+template<typename T, typename Compare = std::less<T>>
+bool is_sorted(const Vector<T> &values, Compare comp = Compare()) {
+    return std::is_sorted(values.data(), values.data() + values.size(), comp);
+}
+
+TEST(Sort, RadixIntegers) {
+    auto values = random_values<uint64_t>(10000, 42);
+    auto expected(values);
+    std::sort(expected.data(), expected.data() + expected.size());
+    radix_sort(values);
+    EXPECT_TRUE(values == expected);
+
+    auto signed_values = random_values<int32_t>(5000, 7);
+    signed_values.push_back(std::numeric_limits<int32_t>::min());
+    signed_values.push_back(std::numeric_limits<int32_t>::max());
+    msd_radix_sort(signed_values);
+    EXPECT_TRUE(is_sorted(signed_values));
+    EXPECT_EQ(signed_values.front(), std::numeric_limits<int32_t>::min());
+}
+
+TEST(Sort, RadixFloats) {
+    const double data[] = {3.5, -0.0, -2.25, 1e300, -1e-300, 0.0, -7.0, 2.0, -std::numeric_limits<double>::infinity()};
+    Vector<double> values;
+    for (size_t round = 0; round < 40; ++round) {
+        for (double value : data) {
+            values.push_back(value * (round + 1));
+        }
+    }
+    radix_sort(values);
+    EXPECT_TRUE(is_sorted(values));
+    Vector<float> floats;
+    for (size_t i = 0; i < 1000; ++i) {
+        floats.push_back(static_cast<float>(i % 37) - 18.5f);
+    }
+    parallel_radix_sort(floats, IdentityKey(), 3);
+    EXPECT_TRUE(is_sorted(floats));
+}
+
+TEST(Sort, SmallFloatsMatchRadixOrder) {
+    const double data[] = {2.0, std::numeric_limits<double>::quiet_NaN(), 0.0, -1.5, -0.0,
+                           std::numeric_limits<double>::infinity(), -3.0, 0.5};
+    const size_t copies = 300;
+    Vector<double> small;
+    Vector<double> large;
+    for (double value : data) {
+        small.push_back(value);
+        for (size_t i = 0; i < copies; ++i) {
+            large.push_back(value);
+        }
+    }
+    auto msd_small(small);
+    auto vector_small(small);
+    radix_sort(small);
+    msd_radix_sort(msd_small);
+    sort_vector(vector_small);
+    radix_sort(large);
+    EXPECT_TRUE(std::signbit(small[2]));
+    EXPECT_FALSE(std::signbit(small[3]));
+    EXPECT_TRUE(std::isnan(small.back()));
+    for (size_t i = 0; i < small.size(); ++i) {
+        EXPECT_EQ(std::memcmp(&small[i], &large[i * copies], sizeof(double)), 0);
+        EXPECT_EQ(std::memcmp(&small[i], &msd_small[i], sizeof(double)), 0);
+        EXPECT_EQ(std::memcmp(&small[i], &vector_small[i], sizeof(double)), 0);
+    }
+}
+
+TEST(Sort, KeyExtractorIsStable) {
+    Vector<std::pair<uint32_t, uint32_t>> pairs;
+    for (uint32_t i = 0; i < 3000; ++i) {
+        pairs.push_back(std::make_pair((i * 7919u) % 100u, i));
+    }
+    auto key = [](const std::pair<uint32_t, uint32_t> &pair) { return pair.first; };
+    auto parallel_pairs(pairs);
+    radix_sort(pairs, key);
+    parallel_radix_sort(parallel_pairs, key, 4);
+    for (size_t i = 1; i < pairs.size(); ++i) {
+        EXPECT_TRUE(pairs[i - 1].first < pairs[i].first
+                    || (pairs[i - 1].first == pairs[i].first && pairs[i - 1].second < pairs[i].second));
+    }
+    EXPECT_TRUE(pairs == parallel_pairs);
+}
+
+TEST(Sort, SmallInputsAreStable) {
+    auto key = [](const std::pair<uint32_t, uint32_t> &pair) { return pair.first; };
+    for (uint32_t size : {30u, 100u, 255u, 256u}) {
+        Vector<std::pair<uint32_t, uint32_t>> pairs;
+        for (uint32_t i = 0; i < size; ++i) {
+            pairs.push_back(std::make_pair((i * 7919u) % 7u, i));
+        }
+        auto parallel_pairs(pairs);
+        radix_sort(pairs, key);
+        parallel_radix_sort(parallel_pairs, key, 4);
+        for (size_t i = 1; i < pairs.size(); ++i) {
+            EXPECT_TRUE(pairs[i - 1].first < pairs[i].first
+                        || (pairs[i - 1].first == pairs[i].first && pairs[i - 1].second < pairs[i].second));
+        }
+        EXPECT_TRUE(pairs == parallel_pairs);
+    }
+}
+
+TEST(Sort, PdqFallback) {
+    Vector<std::string> strings;
+    for (size_t i = 0; i < 500; ++i) {
+        strings.push_back(std::to_string((i * 7919) % 1000));
+    }
+    sort_vector(strings);
+    EXPECT_TRUE(is_sorted(strings));
+
+    auto descending = random_values<uint32_t>(2000, 3);
+    pdq_sort(descending, std::greater<uint32_t>());
+    EXPECT_TRUE(is_sorted(descending, std::greater<uint32_t>()));
+
+    Vector<int> patterns;
+    for (int i = 0; i < 3000; ++i) {
+        patterns.push_back(i % 2 == 0 ? i : 3000 - i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+        patterns.push_back(5);
+    }
+    pdq_sort(patterns);
+    EXPECT_TRUE(is_sorted(patterns));
+
+    auto small = random_values<int64_t>(100, 9);
+    sort_vector(small);
+    EXPECT_TRUE(is_sorted(small));
+}
+
+TEST(Vector, DestructorDestroysAllElements) {
+    {
+        Vector<ThrowingCopy> vec(10);
+        EXPECT_EQ(ThrowingCopy::alive(), 10);
+    }
+    EXPECT_EQ(ThrowingCopy::alive(), 0);
+}
+
+TEST(JaggedVector, PushRows) {
+    JaggedVector<uint32_t> jagged;
+    EXPECT_TRUE(jagged.empty());
+    EXPECT_THROW(jagged.push_back(1), std::out_of_range);
+    jagged.push_row({1, 2, 3});
+    jagged.push_row();
+    jagged.push_row({4});
+    jagged.push_back(5);
+    jagged.push_back(6);
+    EXPECT_EQ(jagged.rows(), 3);
+    EXPECT_EQ(jagged.size(), 6);
+    EXPECT_EQ(jagged[0].size(), 3);
+    EXPECT_EQ(jagged[0][2], 3);
+    EXPECT_TRUE(jagged[1].empty());
+    EXPECT_EQ(jagged[2].size(), 3);
+    EXPECT_EQ(jagged[2][2], 6);
+    jagged[2][0] = 40;
+    EXPECT_EQ(jagged.values()[3], 40);
+    uint32_t sum = 0;
+    for (auto value : jagged.at(2)) {
+        sum += value;
+    }
+    EXPECT_EQ(sum, 51);
+    EXPECT_THROW(jagged.at(3), std::out_of_range);
+    jagged.clear();
+    EXPECT_EQ(jagged.rows(), 0);
+}
+
+TEST(JaggedVector, DuplicateRow) {
+    JaggedVector<std::string> jagged;
+    jagged.push_row({"alpha", "beta", "gamma"});
+    jagged.push_row({"delta"});
+    jagged.push_row({"epsilon", "zeta"});
+    EXPECT_EQ(jagged.size(), jagged.values().capacity());
+    jagged.push_row(jagged[0].data(), jagged[0].size());
+    jagged.push_row(jagged[3].data() + 1, 2);
+    EXPECT_EQ(jagged.rows(), 5);
+    EXPECT_EQ(jagged[3].size(), 3);
+    EXPECT_EQ(jagged[3][0], "alpha");
+    EXPECT_EQ(jagged[3][2], "gamma");
+    EXPECT_EQ(jagged[4][0], "beta");
+    EXPECT_EQ(jagged[4][1], "gamma");
+    EXPECT_EQ(jagged[0][1], "beta");
+}
+
+TEST(JaggedVector, FromNestedVector) {
+    Vector<Vector<uint32_t>> nested;
+    for (uint32_t row = 0; row < 50; ++row) {
+        Vector<uint32_t> values;
+        for (uint32_t i = 0; i < row % 7; ++i) {
+            values.push_back(row * 100 + i);
+        }
+        nested.push_back(std::move(values));
+    }
+    const JaggedVector<uint32_t> jagged(nested);
+    EXPECT_EQ(jagged.rows(), nested.size());
+    for (size_t row = 0; row < nested.size(); ++row) {
+        ASSERT_EQ(jagged[row].size(), nested[row].size());
+        for (size_t i = 0; i < nested[row].size(); ++i) {
+            EXPECT_EQ(jagged[row][i], nested[row][i]);
+        }
+    }
+}
+
+TEST(JaggedVector, Builders) {
+    const uint32_t edges[][2] = {{2, 0}, {0, 1}, {2, 1}, {0, 2}, {3, 3}, {2, 3}};
+    JaggedVector<uint32_t>::Builder builder(4);
+    for (const auto &edge : edges) {
+        builder.count(edge[0]);
+    }
+    EXPECT_THROW(builder.count(4), std::out_of_range);
+    for (const auto &edge : edges) {
+        builder.add(edge[0], edge[1]);
+    }
+    EXPECT_THROW(builder.add(1, 0), std::out_of_range);
+    EXPECT_THROW(builder.add(4, 0), std::out_of_range);
+    EXPECT_THROW(builder.count(1), std::logic_error);
+    const auto graph = builder.finish();
+    EXPECT_EQ(graph.rows(), 4);
+    EXPECT_EQ(graph[0].size(), 2);
+    EXPECT_EQ(graph[0][1], 2);
+    EXPECT_TRUE(graph[1].empty());
+    EXPECT_EQ(graph[2].size(), 3);
+    EXPECT_EQ(graph[2][2], 3);
+    EXPECT_EQ(graph[3][0], 3);
+
+    const auto triangle = JaggedVector<size_t>::build(
+            100, [](size_t row) { return row; },
+            [](size_t row, size_t *out) {
+                for (size_t i = 0; i < row; ++i) {
+                    out[i] = row + i;
+                }
+            }, 3);
+    EXPECT_EQ(triangle.rows(), 100);
+    EXPECT_EQ(triangle.size(), 4950);
+    EXPECT_EQ(triangle[99].size(), 99);
+    EXPECT_EQ(triangle[99][98], 197);
+    EXPECT_EQ(triangle[50][0], 50);
+}
+
+std::string write_file(const std::string &name, const std::string &contents) {
+    const std::string path = testing::TempDir() + name;
+    std::FILE *file = std::fopen(path.c_str(), "wb");
+    std::fwrite(contents.data(), 1, contents.size(), file);
+    std::fclose(file);
+    return path;
+}
+
+TEST(Ingest, TextAcrossChunks) {
+    std::string contents = "  1,22;333\t-4444\r\n";
+    int64_t expected_sum = 1 + 22 + 333 - 4444;
+    for (int64_t i = 0; i < 2000; ++i) {
+        contents += std::to_string(i * 37) + (i % 3 == 0 ? "\n" : ", ");
+        expected_sum += i * 37;
+    }
+    contents += "99";
+    expected_sum += 99;
+    const std::string path = write_file("ingest_text.txt", contents);
+    for (size_t threads : {1, 3}) {
+        IngestOptions options;
+        options.chunk_size = 7;
+        options.threads = threads;
+        Vector<int64_t> values;
+        values.push_back(0);
+        ingest_text(path, values, options);
+        ASSERT_EQ(values.size(), 2006);
+        EXPECT_EQ(values[1], 1);
+        EXPECT_EQ(values[4], -4444);
+        EXPECT_EQ(values.back(), 99);
+        int64_t sum = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            sum += values[i];
+        }
+        EXPECT_EQ(sum, expected_sum);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(Ingest, TextFloatsAndErrors) {
+    const std::string path = write_file("ingest_floats.txt", "1.5 -2.25e3\n0.125,1e-3\n");
+    Vector<double> values;
+    ingest_text(path, values);
+    ASSERT_EQ(values.size(), 4);
+    EXPECT_EQ(values[0], 1.5);
+    EXPECT_EQ(values[1], -2250.0);
+    EXPECT_EQ(values[3], 1e-3);
+    IngestOptions unchunked;
+    unchunked.chunk_size = 0;
+    unchunked.threads = 2;
+    Vector<double> clamped;
+    ingest_text(path, clamped, unchunked);
+    EXPECT_TRUE(clamped == values);
+    Vector<uint32_t> integers;
+    EXPECT_THROW(ingest_text(path, integers), std::runtime_error);
+    std::remove(path.c_str());
+
+    const std::string bad = write_file("ingest_bad.txt", "12 34x 56");
+    EXPECT_THROW(ingest_text(bad, integers), std::runtime_error);
+    std::remove(bad.c_str());
+    EXPECT_THROW(ingest_text(testing::TempDir() + "ingest_missing.txt", integers), std::runtime_error);
+}
+
+TEST(Ingest, Binary) {
+    std::string contents;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        const uint32_t value = i * i;
+        contents.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    const std::string path = write_file("ingest_binary.bin", contents);
+    IngestOptions options;
+    options.chunk_size = 30;
+    Vector<uint32_t> values;
+    ingest_binary(path, values, options);
+    ASSERT_EQ(values.size(), 1000);
+    EXPECT_EQ(values[999], 999u * 999u);
+    Vector<uint64_t> wide;
+    contents.push_back('x');
+    const std::string odd = write_file("ingest_odd.bin", contents);
+    EXPECT_THROW(ingest_binary(odd, wide), std::runtime_error);
+    std::remove(path.c_str());
+    std::remove(odd.c_str());
+}